@@ -0,0 +1,55 @@
+# Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
+# Benchmark Collision
+#
+# This script times dynamic collision generation, so builds can be compared. To use it:
+#
+# 1. Open a scene with a Terrain3D node that has regions around the camera.
+# 1. Select your Terrain3D node.
+# 1. In the inspector, click Script (very bottom) and Quick Load benchmark_collision.gd.
+# 1. Adjust the shape size, radius and number of runs. The defaults are the worst case.
+# 1. Click run. The output window and console will report the timings.
+# 1. Clear the script from your Terrain3D node, and restore your collision settings.
+#
+# Each run rebuilds every shape within the radius of the camera focus, generating them on worker
+# threads and swapping them in before returning. Then the shapes in the center are regenerated as
+# if sculpted. Run it on two builds with the same settings and terrain to compare them.
+
+@tool
+extends Terrain3D
+
+@export_range(8, 64, 8) var shape_size: int = 64
+@export_range(16, 256, 16) var radius: int = 256
+@export_range(1, 100) var runs: int = 10
+@export var run: bool = false : set = run_benchmark
+
+
+func run_benchmark(value: bool) -> void:
+	if not collision:
+		return
+	collision.mode = Terrain3DCollision.DYNAMIC_EDITOR if Engine.is_editor_hint() else Terrain3DCollision.DYNAMIC_GAME
+	collision.radius = radius
+	collision.shape_size = shape_size
+	print("Benchmarking collision, shape size: %d, radius: %d, runs: %d" % [ shape_size, radius, runs ])
+
+	var update_usec: Array[int] = []
+	var invalidate_usec: Array[int] = []
+	var center: Vector3 = get_snapped_position()
+	var area := AABB(center - Vector3(radius, 0, radius) * vertex_spacing * .5, Vector3(radius, 0, radius) * vertex_spacing)
+	for i in runs:
+		var time: int = Time.get_ticks_usec()
+		collision.update(true)
+		update_usec.append(Time.get_ticks_usec() - time)
+		time = Time.get_ticks_usec()
+		collision.invalidate_area(area)
+		invalidate_usec.append(Time.get_ticks_usec() - time)
+
+	print("Rebuild all shapes: %s" % _summarize(update_usec))
+	print("Invalidate center area: %s" % _summarize(invalidate_usec))
+
+
+func _summarize(usecs: Array[int]) -> String:
+	usecs.sort()
+	var total: int = 0
+	for usec in usecs:
+		total += usec
+	return "min %.2fms, median %.2fms, mean %.2fms" % [ usecs[0] * .001, usecs[usecs.size() / 2] * .001, total * .001 / usecs.size() ]
@@ -0,0 +1,60 @@
+# Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
+# Benchmark Region Load
+#
+# This script compares the load time of .res and raw .t3dr region files. To use it:
+#
+# 1. Save your scene. Regions with unsaved changes stop the benchmark, as it reloads the data.
+# 1. Back up your data directory. The files are converted between both formats in place.
+# 1. Select your Terrain3D node.
+# 1. In the inspector, click Script (very bottom) and Quick Load benchmark_region_load.gd.
+# 1. Set the number of runs, and click run. The output window and console will report the timings.
+# 1. Clear the script from your Terrain3D node.
+#
+# The files are converted to .res, loaded several times, then converted to .t3dr and loaded again.
+# They are converted back to the format most of them started in, and reloaded.
+
+@tool
+extends Terrain3D
+
+@export_range(1, 20) var runs: int = 5
+@export var run: bool = false : set = run_benchmark
+
+
+func run_benchmark(value: bool) -> void:
+	if not data or data_directory.is_empty():
+		return
+	for region: Terrain3DRegion in data.get_regions_all().values():
+		if region.is_modified():
+			push_error("Save the scene before benchmarking. Region %s has unsaved changes" % region.get_location())
+			return
+
+	var raw_count: int = 0
+	var file_count: int = 0
+	for file_name in DirAccess.get_files_at(data_directory):
+		if file_name.begins_with("terrain3d"):
+			file_count += 1
+			raw_count += int(file_name.get_extension() == "t3dr")
+	print("Benchmarking region load, files: %d, runs: %d, directory: %s" % [ file_count, runs, data_directory ])
+
+	for to_raw in [ false, true ]:
+		var err: Error = Terrain3DUtil.convert_region_files(data_directory, to_raw)
+		if err != OK:
+			push_error("Cannot convert region files: %s" % error_string(err))
+			break
+		var usecs: Array[int] = []
+		for i in runs:
+			var time: int = Time.get_ticks_usec()
+			data.load_directory(data_directory)
+			usecs.append(Time.get_ticks_usec() - time)
+		print("%s: %s" % [ ".t3dr" if to_raw else ".res", _summarize(usecs) ])
+
+	Terrain3DUtil.convert_region_files(data_directory, raw_count * 2 > file_count)
+	data.load_directory(data_directory)
+
+
+func _summarize(usecs: Array[int]) -> String:
+	usecs.sort()
+	var total: int = 0
+	for usec in usecs:
+		total += usec
+	return "min %.2fms, median %.2fms, mean %.2fms" % [ usecs[0] * .001, usecs[usecs.size() / 2] * .001, total * .001 / usecs.size() ]
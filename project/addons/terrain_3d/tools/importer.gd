@@ -66,6 +66,13 @@ func start_import(p_value: bool) -> void:
 	if p_value:
 		print("Terrain3DImporter: Importing files:\n\t%s\n\t%s\n\t%s" % [ height_file_name, control_file_name, color_file_name])
 
+		var pos := Vector3(import_position.x, 0, import_position.y)
+		if height_file_name and not control_file_name and not color_file_name:
+			# Reads large height maps in pieces, without loading the whole image
+			var err: int = data.import_height_file(height_file_name, pos, height_offset, import_scale, r16_range, r16_size)
+			print("Terrain3DImporter: Import finished with status: ", error_string(err))
+			return
+
 		var imported_images: Array[Image]
 		imported_images.resize(Terrain3DRegion.TYPE_MAX)
 		var min_max := Vector2(0, 1)
@@ -83,7 +90,6 @@ func start_import(p_value: bool) -> void:
 			if assets.get_texture_count() == 0:
 				material.show_checkered = false
 				material.show_colormap = true
-		var pos := Vector3(import_position.x, 0, import_position.y)
 		data.import_images(imported_images, pos, height_offset, import_scale)
 		print("Terrain3DImporter: Import finished")
 
@@ -19,6 +19,7 @@ void GeneratedTexture::clear() {
 		_image.unref();
 	}
 	_rid = RID();
+	_queued_updates.clear();
 	_dirty = true;
 }
 
@@ -32,6 +33,7 @@ RID GeneratedTexture::create(const TypedArray<Image> &p_layers) {
 			}
 		}
 		_rid = RS->texture_2d_layered_create(p_layers, RenderingServer::TEXTURE_LAYERED_2D_ARRAY);
+		_queued_updates.clear();
 		_dirty = false;
 	} else {
 		clear();
@@ -44,6 +46,24 @@ void GeneratedTexture::update(const Ref<Image> &p_image, const int p_layer) {
 	RS->texture_2d_update(_rid, p_image, p_layer);
 }
 
+// Queues the whole of p_layer for upload on the next upload_queued().
+// Repeated queues of a layer before then are uploaded once.
+void GeneratedTexture::queue_update(const Ref<Image> &p_image, const int p_layer) {
+	if (p_image.is_null()) {
+		return;
+	}
+	_queued_updates[p_layer] = p_image;
+}
+
+void GeneratedTexture::upload_queued() {
+	if (_rid.is_valid()) {
+		for (const auto &[layer, image] : _queued_updates) {
+			update(image, layer);
+		}
+	}
+	_queued_updates.clear();
+}
+
 RID GeneratedTexture::create(const Ref<Image> &p_image) {
 	LOG(EXTREME, "RenderingServer creating Texture2D");
 	_image = p_image;
@@ -4,6 +4,7 @@
 #define GENERATEDTEXTURE_CLASS_H
 
 #include <godot_cpp/classes/image.hpp>
+#include <map>
 
 #include "constants.h"
 
@@ -17,11 +18,17 @@ private:
 	Ref<Image> _image;
 	bool _dirty = false;
 
+	// Layers waiting for upload_queued(), one image per layer
+	std::map<int, Ref<Image>> _queued_updates;
+
 public:
 	void clear();
 	bool is_dirty() const { return _dirty; }
 	RID create(const TypedArray<Image> &p_layers);
 	void update(const Ref<Image> &p_image, const int p_layer);
+	void queue_update(const Ref<Image> &p_image, const int p_layer);
+	bool has_queued_updates() const { return !_queued_updates.empty(); }
+	void upload_queued();
 	RID create(const Ref<Image> &p_image);
 	Ref<Image> get_image() const { return _image; }
 	RID get_rid() const { return _rid; }
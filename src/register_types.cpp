@@ -1,14 +1,18 @@
 // Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
 
 #include <gdextension_interface.h>
+#include <godot_cpp/classes/resource_loader.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
 #include "register_types.h"
 #include "terrain_3d.h"
 #include "terrain_3d_editor.h"
+#include "terrain_3d_region_loader.h"
 
 using namespace godot;
 
+static Ref<Terrain3DRegionLoader> region_loader;
+
 void initialize_terrain_3d(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
@@ -17,19 +21,26 @@ void initialize_terrain_3d(ModuleInitializationLevel p_level) {
 	ClassDB::register_class<Terrain3DAssets>();
 	ClassDB::register_class<Terrain3DData>();
 	ClassDB::register_class<Terrain3DEditor>();
+	ClassDB::register_class<Terrain3DHeightSampler>();
 	ClassDB::register_class<Terrain3DCollision>();
 	ClassDB::register_class<Terrain3DInstancer>();
 	ClassDB::register_class<Terrain3DMaterial>();
 	ClassDB::register_class<Terrain3DMeshAsset>();
 	ClassDB::register_class<Terrain3DRegion>();
+	ClassDB::register_class<Terrain3DRegionLoader>();
 	ClassDB::register_class<Terrain3DTextureAsset>();
 	ClassDB::register_class<Terrain3DUtil>();
+
+	region_loader.instantiate();
+	ResourceLoader::get_singleton()->add_resource_format_loader(region_loader);
 }
 
 void uninitialize_terrain_3d(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+	ResourceLoader::get_singleton()->remove_resource_format_loader(region_loader);
+	region_loader.unref();
 }
 
 extern "C" {
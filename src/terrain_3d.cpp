@@ -62,9 +62,9 @@ void Terrain3D::_initialize() {
 		_data->connect("region_map_changed", callable_mp(this, &Terrain3D::update_region_labels));
 	}
 	// Any region was changed, regenerate collision if enabled
-	if (!_data->is_connected("region_map_changed", callable_mp(_collision, &Terrain3DCollision::build))) {
-		LOG(DEBUG, "Connecting _data::region_map_changed signal to build()");
-		_data->connect("region_map_changed", callable_mp(_collision, &Terrain3DCollision::build));
+	if (!_data->is_connected("region_map_changed", callable_mp(_collision, &Terrain3DCollision::update_regions))) {
+		LOG(DEBUG, "Connecting _data::region_map_changed signal to update_regions()");
+		_data->connect("region_map_changed", callable_mp(_collision, &Terrain3DCollision::update_regions));
 	}
 	// Any map was regenerated or regions changed, update material
 	if (!_data->is_connected("maps_changed", callable_mp(_material.ptr(), &Terrain3DMaterial::_update_maps))) {
@@ -108,14 +108,20 @@ void Terrain3D::__physics_process(const double p_delta) {
 	if (!_initialized)
 		return;
 
+	_data->update_loading();
+	_data->update_saving();
+
 	// If the game/editor camera is not set, find it
 	if (!is_instance_valid(_camera_instance_id, _camera)) {
-		LOG(DEBUG, "Camera is null, getting the current one");
+		if (!_camera_missing) {
+			LOG(DEBUG, "Camera is null, getting the current one");
+		}
 		_grab_camera();
 	}
 
 	// If camera has moved enough, re-center the terrain on it.
-	if (is_instance_valid(_camera_instance_id) && _camera->is_inside_tree()) {
+	bool has_camera = is_instance_valid(_camera_instance_id) && _camera->is_inside_tree();
+	if (has_camera) {
 		Vector3 cam_pos = _camera->get_global_position();
 		Vector2 cam_pos_2d = Vector2(cam_pos.x, cam_pos.z);
 		if (_camera_last_position.distance_to(cam_pos_2d) > 0.2f) {
@@ -123,26 +129,41 @@ void Terrain3D::__physics_process(const double p_delta) {
 			_camera_last_position = cam_pos_2d;
 		}
 	}
+
+	// Collision swaps in shapes generated on worker threads, and follows its focus points, even
+	// while the camera is still
+	if (_collision && (_collision->is_dynamic_mode() || _collision->is_generating())) {
+		_collision->update();
+	}
+
+	// Streaming follows the focus points, or the camera if none are set
+	if (_streaming_enabled && !IS_EDITOR) {
+		_data->update_streaming(has_camera ? _camera->get_global_position() : V3_MAX);
+	}
 }
 
 /**
  * If running in the editor, grab the first editor viewport camera.
  * The edited_scene_root is excluded in case the user already has a Camera3D in their scene.
+ * Without a camera, processing continues so streaming and collision can follow their focus points,
+ * eg. on a dedicated server. The search is repeated each frame, but only the first failure is logged.
  */
 void Terrain3D::_grab_camera() {
 	if (IS_EDITOR) {
 		_camera = EditorInterface::get_singleton()->get_editor_viewport_3d(0)->get_camera_3d();
-		LOG(DEBUG, "Grabbing the first editor viewport camera: ", _camera);
 	} else {
 		_camera = get_viewport()->get_camera_3d();
-		LOG(DEBUG, "Grabbing the in-game viewport camera: ", _camera);
 	}
 	if (_camera) {
+		LOG(DEBUG, "Grabbing the ", IS_EDITOR ? "first editor viewport" : "in-game viewport", " camera: ", _camera);
 		_camera_instance_id = _camera->get_instance_id();
+		_camera_missing = false;
 	} else {
 		_camera_instance_id = 0;
-		set_physics_process(false); // disable snapping
-		LOG(ERROR, "Cannot find the active camera. Set it manually with Terrain3D.set_camera(). Stopping _process()");
+		if (!_camera_missing) {
+			LOG(WARN, "Cannot find the active camera. Set it manually with Terrain3D.set_camera(). Terrain meshes won't follow it until found");
+		}
+		_camera_missing = true;
 	}
 }
 
@@ -633,6 +654,7 @@ void Terrain3D::set_camera(Camera3D *p_camera) {
 		} else {
 			_camera = p_camera;
 			_camera_instance_id = _camera->get_instance_id();
+			_camera_missing = false;
 			LOG(DEBUG, "Setting camera: ", _camera);
 			_initialize();
 			set_physics_process(true); // enable snapping
@@ -659,6 +681,38 @@ void Terrain3D::set_save_16_bit(const bool p_enabled) {
 	_save_16_bit = p_enabled;
 }
 
+void Terrain3D::set_save_in_background(const bool p_enabled) {
+	LOG(INFO, "Setting save in background: ", p_enabled);
+	_save_in_background = p_enabled;
+}
+
+// Takes effect when the map texture arrays are next rebuilt
+void Terrain3D::set_region_layer_reserve(const int p_layers) {
+	LOG(INFO, "Setting region layer reserve: ", p_layers);
+	_region_layer_reserve = CLAMP(p_layers, 0, 64);
+}
+
+// Takes effect when the data directory is next loaded. The editor always loads all regions.
+void Terrain3D::set_streaming_enabled(const bool p_enabled) {
+	LOG(INFO, "Setting region streaming: ", p_enabled);
+	_streaming_enabled = p_enabled;
+}
+
+void Terrain3D::set_streaming_load_distance(const real_t p_distance) {
+	_streaming_load_distance = CLAMP(p_distance, 0.f, 100000.f);
+	LOG(INFO, "Setting streaming load distance: ", _streaming_load_distance);
+}
+
+void Terrain3D::set_streaming_unload_distance(const real_t p_distance) {
+	_streaming_unload_distance = CLAMP(p_distance, 0.f, 100000.f);
+	LOG(INFO, "Setting streaming unload distance: ", _streaming_unload_distance);
+}
+
+void Terrain3D::set_streaming_memory_budget(const int p_megabytes) {
+	_streaming_memory_budget = MAX(p_megabytes, 0);
+	LOG(INFO, "Setting streaming memory budget: ", _streaming_memory_budget, " MB");
+}
+
 void Terrain3D::set_label_distance(const real_t p_distance) {
 	real_t distance = CLAMP(p_distance, 0.f, 100000.f);
 	LOG(INFO, "Setting region label distance: ", distance);
@@ -886,10 +940,6 @@ void Terrain3D::snap(const Vector3 &p_cam_pos) {
 			edge++;
 		}
 	}
-
-	if (_collision && _collision->is_dynamic_mode()) {
-		_collision->update();
-	}
 }
 
 void Terrain3D::update_aabbs() {
@@ -939,7 +989,7 @@ void Terrain3D::update_aabbs() {
 /* Returns the point a ray intersects the ground using either raymarching or the GPU depth texture
  *	p_src_pos (camera position)
  *	p_direction (camera direction looking at the terrain)
- *  p_gpu_mode - false: use raymarching, true: use GPU mode
+ *  p_gpu_mode - false: use a heightfield raycast, true: use GPU mode
  * Returns Vec3(NAN) on error or vec3(3.402823466e+38F) on no intersection. Test w/ if (var.x < 3.4e38)
  */
 Vector3 Terrain3D::get_intersection(const Vector3 &p_src_pos, const Vector3 &p_direction, const bool p_gpu_mode) {
@@ -967,16 +1017,8 @@ Vector3 Terrain3D::get_intersection(const Vector3 &p_src_pos, const Vector3 &p_d
 		}
 
 	} else if (!p_gpu_mode) {
-		// Else if not gpu mode, use raymarching mode
-		point = p_src_pos;
-		for (int i = 0; i < 4000; i++) {
-			real_t height = _data->get_height(point);
-			if (point.y - height <= 0) {
-				return point;
-			}
-			point += direction;
-		}
-		return V3_MAX;
+		// Else if not gpu mode, raycast against the height maps
+		return _data->get_height_sampler()->get_ray_intersection(p_src_pos, direction);
 
 	} else {
 		// Else use GPU mode, which requires multiple calls
@@ -1018,6 +1060,18 @@ Vector3 Terrain3D::get_intersection(const Vector3 &p_src_pos, const Vector3 &p_d
 	return point;
 }
 
+/**
+ * Raycasts each origin and direction pair against the height maps, as the CPU mode of
+ * get_intersection(), without requiring a camera. Misses are V3_MAX. The arrays must be the same size.
+ */
+PackedVector3Array Terrain3D::get_intersections(const PackedVector3Array &p_origins, const PackedVector3Array &p_directions) const {
+	if (_data == nullptr) {
+		LOG(ERROR, "Data not initialized");
+		return PackedVector3Array();
+	}
+	return _data->get_height_sampler()->get_ray_intersections(p_origins, p_directions);
+}
+
 /**
  * Generates a static ArrayMesh for the terrain.
  * p_lod (0-8): Determines the granularity of the generated mesh.
@@ -1275,11 +1329,25 @@ void Terrain3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_region_size"), &Terrain3D::get_region_size);
 	ClassDB::bind_method(D_METHOD("set_save_16_bit", "enabled"), &Terrain3D::set_save_16_bit);
 	ClassDB::bind_method(D_METHOD("get_save_16_bit"), &Terrain3D::get_save_16_bit);
+	ClassDB::bind_method(D_METHOD("set_save_in_background", "enabled"), &Terrain3D::set_save_in_background);
+	ClassDB::bind_method(D_METHOD("get_save_in_background"), &Terrain3D::get_save_in_background);
+	ClassDB::bind_method(D_METHOD("set_region_layer_reserve", "layers"), &Terrain3D::set_region_layer_reserve);
+	ClassDB::bind_method(D_METHOD("get_region_layer_reserve"), &Terrain3D::get_region_layer_reserve);
 	ClassDB::bind_method(D_METHOD("set_label_distance", "distance"), &Terrain3D::set_label_distance);
 	ClassDB::bind_method(D_METHOD("get_label_distance"), &Terrain3D::get_label_distance);
 	ClassDB::bind_method(D_METHOD("set_label_size", "size"), &Terrain3D::set_label_size);
 	ClassDB::bind_method(D_METHOD("get_label_size"), &Terrain3D::get_label_size);
 
+	// Streaming
+	ClassDB::bind_method(D_METHOD("set_streaming_enabled", "enabled"), &Terrain3D::set_streaming_enabled);
+	ClassDB::bind_method(D_METHOD("get_streaming_enabled"), &Terrain3D::get_streaming_enabled);
+	ClassDB::bind_method(D_METHOD("set_streaming_load_distance", "distance"), &Terrain3D::set_streaming_load_distance);
+	ClassDB::bind_method(D_METHOD("get_streaming_load_distance"), &Terrain3D::get_streaming_load_distance);
+	ClassDB::bind_method(D_METHOD("set_streaming_unload_distance", "distance"), &Terrain3D::set_streaming_unload_distance);
+	ClassDB::bind_method(D_METHOD("get_streaming_unload_distance"), &Terrain3D::get_streaming_unload_distance);
+	ClassDB::bind_method(D_METHOD("set_streaming_memory_budget", "megabytes"), &Terrain3D::set_streaming_memory_budget);
+	ClassDB::bind_method(D_METHOD("get_streaming_memory_budget"), &Terrain3D::get_streaming_memory_budget);
+
 	// Collision
 	ClassDB::bind_method(D_METHOD("set_collision_mode", "mode"), &Terrain3D::set_collision_mode);
 	ClassDB::bind_method(D_METHOD("get_collision_mode"), &Terrain3D::get_collision_mode);
@@ -1287,6 +1355,12 @@ void Terrain3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_collision_shape_size"), &Terrain3D::get_collision_shape_size);
 	ClassDB::bind_method(D_METHOD("set_collision_radius", "radius"), &Terrain3D::set_collision_radius);
 	ClassDB::bind_method(D_METHOD("get_collision_radius"), &Terrain3D::get_collision_radius);
+	ClassDB::bind_method(D_METHOD("set_collision_lods", "lods"), &Terrain3D::set_collision_lods);
+	ClassDB::bind_method(D_METHOD("get_collision_lods"), &Terrain3D::get_collision_lods);
+	ClassDB::bind_method(D_METHOD("set_collision_prediction_time", "seconds"), &Terrain3D::set_collision_prediction_time);
+	ClassDB::bind_method(D_METHOD("get_collision_prediction_time"), &Terrain3D::get_collision_prediction_time);
+	ClassDB::bind_method(D_METHOD("set_collision_camera_focus", "enabled"), &Terrain3D::set_collision_camera_focus);
+	ClassDB::bind_method(D_METHOD("get_collision_camera_focus"), &Terrain3D::get_collision_camera_focus);
 	ClassDB::bind_method(D_METHOD("set_collision_layer", "layers"), &Terrain3D::set_collision_layer);
 	ClassDB::bind_method(D_METHOD("get_collision_layer"), &Terrain3D::get_collision_layer);
 	ClassDB::bind_method(D_METHOD("set_collision_mask", "mask"), &Terrain3D::set_collision_mask);
@@ -1354,6 +1428,7 @@ void Terrain3D::_bind_methods() {
 
 	// Utility
 	ClassDB::bind_method(D_METHOD("get_intersection", "src_pos", "direction", "gpu_mode"), &Terrain3D::get_intersection, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_intersections", "origins", "directions"), &Terrain3D::get_intersections);
 	ClassDB::bind_method(D_METHOD("bake_mesh", "lod", "filter"), &Terrain3D::bake_mesh);
 	ClassDB::bind_method(D_METHOD("generate_nav_mesh_source_geometry", "global_aabb", "require_nav"), &Terrain3D::generate_nav_mesh_source_geometry, DEFVAL(true));
 
@@ -1371,14 +1446,25 @@ void Terrain3D::_bind_methods() {
 	ADD_GROUP("Regions", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "region_size", PROPERTY_HINT_ENUM, "64:64,128:128,256:256,512:512,1024:1024,2048:2048", PROPERTY_USAGE_EDITOR), "change_region_size", "get_region_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "save_16_bit"), "set_save_16_bit", "get_save_16_bit");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "save_in_background"), "set_save_in_background", "get_save_in_background");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "region_layer_reserve", PROPERTY_HINT_RANGE, "0,64,1"), "set_region_layer_reserve", "get_region_layer_reserve");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "label_distance", PROPERTY_HINT_RANGE, "0.0,10000.0,0.5,or_greater"), "set_label_distance", "get_label_distance");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "label_size", PROPERTY_HINT_RANGE, "24,128,1"), "set_label_size", "get_label_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "show_grid"), "set_show_region_grid", "get_show_region_grid");
 
+	ADD_GROUP("Streaming", "streaming_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "streaming_enabled"), "set_streaming_enabled", "get_streaming_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "streaming_load_distance", PROPERTY_HINT_RANGE, "0.0,16384.0,1.0,or_greater"), "set_streaming_load_distance", "get_streaming_load_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "streaming_unload_distance", PROPERTY_HINT_RANGE, "0.0,16384.0,1.0,or_greater"), "set_streaming_unload_distance", "get_streaming_unload_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "streaming_memory_budget", PROPERTY_HINT_RANGE, "0,65536,1,or_greater,suffix:MB"), "set_streaming_memory_budget", "get_streaming_memory_budget");
+
 	ADD_GROUP("Collision", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_mode", PROPERTY_HINT_ENUM, "Disabled,Dynamic / Game,Dynamic / Editor,Full / Game,Full / Editor"), "set_collision_mode", "get_collision_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_shape_size", PROPERTY_HINT_RANGE, "8,64,8"), "set_collision_shape_size", "get_collision_shape_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_radius", PROPERTY_HINT_RANGE, "16,256,16"), "set_collision_radius", "get_collision_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_lods", PROPERTY_HINT_RANGE, "1,8,1"), "set_collision_lods", "get_collision_lods");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "collision_prediction_time", PROPERTY_HINT_RANGE, "0,10,.1,suffix:s"), "set_collision_prediction_time", "get_collision_prediction_time");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_camera_focus"), "set_collision_camera_focus", "get_collision_camera_focus");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_layer", "get_collision_layer");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_mask", "get_collision_mask");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "collision_priority", PROPERTY_HINT_RANGE, "0.1,256,.1"), "set_collision_priority", "get_collision_priority");
@@ -54,15 +54,24 @@ private:
 	// Current editor or gameplay camera we are centering the terrain on.
 	Camera3D *_camera = nullptr;
 	uint64_t _camera_instance_id = 0;
+	bool _camera_missing = false; // No camera was found, so it's searched for quietly each frame
 	// X,Z Position of the camera during the previous snapping. Set to max real_t value to force a snap update.
 	Vector2 _camera_last_position = V2_MAX;
 
 	// Regions
 	RegionSize _region_size = SIZE_256;
 	bool _save_16_bit = false;
+	bool _save_in_background = false;
+	int _region_layer_reserve = 4;
 	real_t _label_distance = 0.f;
 	int _label_size = 48;
 
+	// Streaming
+	bool _streaming_enabled = false;
+	real_t _streaming_load_distance = 1024.f;
+	real_t _streaming_unload_distance = 1536.f;
+	int _streaming_memory_budget = 0; // MB, 0 = unlimited
+
 	// Meshes
 	int _mesh_lods = 7;
 	int _mesh_size = 48;
@@ -153,12 +162,26 @@ public:
 	void change_region_size(const RegionSize p_size) { (_data != nullptr) ? _data->change_region_size(p_size) : void(); }
 	void set_save_16_bit(const bool p_enabled);
 	bool get_save_16_bit() const { return _save_16_bit; }
+	void set_save_in_background(const bool p_enabled);
+	bool get_save_in_background() const { return _save_in_background; }
+	void set_region_layer_reserve(const int p_layers);
+	int get_region_layer_reserve() const { return _region_layer_reserve; }
 	void set_label_distance(const real_t p_distance);
 	real_t get_label_distance() const { return _label_distance; }
 	void set_label_size(const int p_size);
 	int get_label_size() const { return _label_size; }
 	void update_region_labels();
 
+	// Streaming
+	void set_streaming_enabled(const bool p_enabled);
+	bool get_streaming_enabled() const { return _streaming_enabled; }
+	void set_streaming_load_distance(const real_t p_distance);
+	real_t get_streaming_load_distance() const { return _streaming_load_distance; }
+	void set_streaming_unload_distance(const real_t p_distance);
+	real_t get_streaming_unload_distance() const { return _streaming_unload_distance; }
+	void set_streaming_memory_budget(const int p_megabytes);
+	int get_streaming_memory_budget() const { return _streaming_memory_budget; }
+
 	// Meshes
 	void set_mesh_lods(const int p_count);
 	int get_mesh_lods() const { return _mesh_lods; }
@@ -187,6 +210,7 @@ public:
 
 	// Utility
 	Vector3 get_intersection(const Vector3 &p_src_pos, const Vector3 &p_direction, const bool p_gpu_mode = false);
+	PackedVector3Array get_intersections(const PackedVector3Array &p_origins, const PackedVector3Array &p_directions) const;
 	Ref<Mesh> bake_mesh(const int p_lod, const Terrain3DData::HeightFilter p_filter = Terrain3DData::HEIGHT_FILTER_NEAREST) const;
 	PackedVector3Array generate_nav_mesh_source_geometry(const AABB &p_global_aabb, const bool p_require_nav = true) const;
 
@@ -202,6 +226,12 @@ public:
 	uint16_t get_collision_shape_size() const { return (_collision != nullptr) ? _collision->get_shape_size() : 16; }
 	void set_collision_radius(const uint16_t p_radius) { (_collision != nullptr) ? _collision->set_radius(p_radius) : void(); }
 	uint16_t get_collision_radius() const { return (_collision != nullptr) ? _collision->get_radius() : 64; }
+	void set_collision_lods(const uint8_t p_lods) { (_collision != nullptr) ? _collision->set_lods(p_lods) : void(); }
+	uint8_t get_collision_lods() const { return (_collision != nullptr) ? _collision->get_lods() : 1; }
+	void set_collision_prediction_time(const real_t p_seconds) { (_collision != nullptr) ? _collision->set_prediction_time(p_seconds) : void(); }
+	real_t get_collision_prediction_time() const { return (_collision != nullptr) ? _collision->get_prediction_time() : 0.f; }
+	void set_collision_camera_focus(const bool p_enabled) { (_collision != nullptr) ? _collision->set_camera_focus(p_enabled) : void(); }
+	bool get_collision_camera_focus() const { return (_collision != nullptr) ? _collision->get_camera_focus() : true; }
 	void set_collision_layer(const uint32_t p_layers) { (_collision != nullptr) ? _collision->set_layer(p_layers) : void(); }
 	uint32_t get_collision_layer() const { return (_collision != nullptr) ? _collision->get_layer() : 1; }
 	void set_collision_mask(const uint32_t p_mask) { (_collision != nullptr) ? _collision->set_mask(p_mask) : void(); }
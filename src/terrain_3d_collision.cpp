@@ -1,9 +1,13 @@
 // Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
 
+#include <godot_cpp/classes/box_shape3d.hpp>
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/height_map_shape3d.hpp>
 #include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/classes/world3d.hpp>
+#include <algorithm>
+#include <set>
 
 #include <godot_cpp/classes/scene_tree.hpp>
 
@@ -16,107 +20,597 @@
 // Private Functions
 ///////////////////////////
 
-// Calculates shape data from top left position. Assumes descaled and snapped.
-Dictionary Terrain3DCollision::_get_shape_data(const Vector2i &p_position, const int p_size) {
-	IS_DATA_INIT_MESG("Terrain not initialized", Dictionary());
+// Full mode shapes split regions into chunks, so they're built and swapped in a few at a time
+int Terrain3DCollision::_get_full_shape_size() const {
+	return MIN(FULL_SHAPE_SIZE, _terrain->get_region_size());
+}
+
+// Prepares a job for the shape of the cell, holding the map data it reads. The cell is the
+// descaled, snapped top left position, and the lod in z. Returns false if there is no region there.
+bool Terrain3DCollision::_init_job(ShapeJob &r_job, const Vector3i &p_cell, const int p_size) {
 	Terrain3DData *data = _terrain->get_data();
 	int region_size = _terrain->get_region_size();
+	int64_t map_bytes = int64_t(region_size) * region_size * sizeof(float);
+	r_job = ShapeJob();
+	r_job.shape_pos = Vector2i(p_cell.x, p_cell.y);
+	r_job.lod = p_cell.z;
+	r_job.size = p_size;
+	int span = p_size << p_cell.z;
 
-	int hshape_size = p_size + 1; // Calculate last vertex at end
-	PackedFloat32Array map_data = PackedFloat32Array();
-	map_data.resize(hshape_size * hshape_size);
-	real_t min_height = FLT_MAX;
-	real_t max_height = FLT_MIN;
-
-	Ref<Image> map, map_x, map_z, map_xz; // height maps
-	Ref<Image> cmap, cmap_x, cmap_z, cmap_xz; // control maps w/ holes
-
-	// Get region_loc of top left corner of descaled and grid snapped collision shape position
-	Vector2i region_loc = V2I_DIVIDE_FLOOR(p_position, region_size);
-	Ref<Terrain3DRegion> region = data->get_region(region_loc);
-	if (region.is_null() || (region.is_valid() && region->is_deleted())) {
-		LOG(EXTREME, "Region not found at: ", region_loc, ". Returning blank");
-		return Dictionary();
+	// Get region_loc of top left corner of descaled and grid snapped collision shape position,
+	// and the regions to +X, +Z it covers, including those the last vertex runs over into
+	Vector2i last_vertex = r_job.shape_pos + V2I(span);
+	Vector2i last_pixel = last_vertex - V2I(1);
+	r_job.region_loc = V2I_DIVIDE_FLOOR(r_job.shape_pos, region_size);
+	r_job.region_count = V2I_DIVIDE_FLOOR(last_vertex, region_size) - r_job.region_loc + V2I(1);
+	// Regions the shape covers, before the last vertex
+	Vector2i inner_count = V2I_DIVIDE_FLOOR(last_pixel, region_size) - r_job.region_loc + V2I(1);
+	int count = r_job.region_count.x * r_job.region_count.y;
+	r_job.heights.resize(count);
+	r_job.controls.resize(count);
+	bool found = false;
+	for (int i = 0; i < count; i++) {
+		Vector2i index = Vector2i(i % r_job.region_count.x, i / r_job.region_count.x);
+		const Terrain3DRegion *region = data->get_region_ptr(r_job.region_loc + index);
+		if (region && !region->is_deleted()) {
+			PackedByteArray heights = region->get_map_ptr(TYPE_HEIGHT)->get_data();
+			PackedByteArray controls = region->get_map_ptr(TYPE_CONTROL)->get_data();
+			if (heights.size() >= map_bytes && controls.size() >= map_bytes) {
+				r_job.heights[i] = heights;
+				r_job.controls[i] = controls;
+				found = found || (index.x < inner_count.x && index.y < inner_count.y);
+			}
+		}
 	}
-	map = region->get_map(TYPE_HEIGHT);
-	cmap = region->get_map(TYPE_CONTROL);
-
-	// Get +X, +Z adjacent regions in case we run over
-	region = data->get_region(region_loc + Vector2i(1, 0));
-	if (region.is_valid() && !region->is_deleted()) {
-		map_x = region->get_map(TYPE_HEIGHT);
-		cmap_x = region->get_map(TYPE_CONTROL);
+	if (!found) {
+		LOG(EXTREME, "Region not found at: ", r_job.region_loc, ". Skipping");
+		return false;
 	}
-	region = data->get_region(region_loc + Vector2i(0, 1));
-	if (region.is_valid() && !region->is_deleted()) {
-		map_z = region->get_map(TYPE_HEIGHT);
-		cmap_z = region->get_map(TYPE_CONTROL);
+	return true;
+}
+
+// Copies the heights of the shape out of the map data held by the job, sampling every 2^lod
+// pixels. Holes become NaN. Safe to call on worker threads.
+void Terrain3DCollision::_extract_heights(ShapeJob &p_job) const {
+	int region_size = _terrain->get_region_size();
+	int step = 1 << p_job.lod;
+	int hshape_size = p_job.size + 1; // Calculate last vertex at end
+	p_job.map_data.resize(hshape_size * hshape_size);
+	float *map_data = p_job.map_data.ptrw();
+	float min_height = FLT_MAX;
+	float max_height = -FLT_MAX;
+	bool holes = false;
+
+	// Direct pointers to the map data, null where there is no region
+	int count = p_job.heights.size();
+	std::vector<const float *> heights(count, nullptr);
+	std::vector<const uint32_t *> controls(count, nullptr);
+	for (int i = 0; i < count; i++) {
+		if (!p_job.heights[i].is_empty()) {
+			heights[i] = reinterpret_cast<const float *>(p_job.heights[i].ptr());
+			controls[i] = reinterpret_cast<const uint32_t *>(p_job.controls[i].ptr());
+		}
 	}
-	region = data->get_region(region_loc + Vector2i(1, 1));
-	if (region.is_valid() && !region->is_deleted()) {
-		map_xz = region->get_map(TYPE_HEIGHT);
-		cmap_xz = region->get_map(TYPE_CONTROL);
+	// Region column and pixel of each sample column, relative to the regions held
+	Vector2i offset = p_job.shape_pos - p_job.region_loc * region_size;
+	std::vector<int> col_region(hshape_size);
+	std::vector<int> col_pixel(hshape_size);
+	for (int x = 0; x < hshape_size; x++) {
+		int px = offset.x + x * step;
+		col_region[x] = px / region_size;
+		col_pixel[x] = px % region_size;
 	}
 
 	for (int z = 0; z < hshape_size; z++) {
+		int py = offset.y + z * step;
+		int row_region = (py / region_size) * p_job.region_count.x;
+		int row_pixel = (py % region_size) * region_size;
+		// Choose array indexing to match triangulation of heightmapshape with the mesh
+		// https://stackoverflow.com/questions/16684856/rotating-a-2d-pixel-array-by-90-degrees
+		// Normal array index rotated Y=0 - shape rotation Y=0 (xform below)
+		// int index = z * hshape_size + x;
+		// Array Index Rotated Y=-90 - must rotate shape Y=+90 (xform below)
+		float *dst = map_data + hshape_size - 1 - z;
 		for (int x = 0; x < hshape_size; x++) {
-			// Choose array indexing to match triangulation of heightmapshape with the mesh
-			// https://stackoverflow.com/questions/16684856/rotating-a-2d-pixel-array-by-90-degrees
-			// Normal array index rotated Y=0 - shape rotation Y=0 (xform below)
-			// int index = z * hshape_size + x;
-			// Array Index Rotated Y=-90 - must rotate shape Y=+90 (xform below)
-			int index = hshape_size - 1 - z + x * hshape_size;
-
-			Vector2i shape_pos = p_position + Vector2i(x, z);
-			Vector2i shape_region_loc = V2I_DIVIDE_FLOOR(shape_pos, region_size);
-			int img_x = Math::posmod(shape_pos.x, region_size);
-			bool next_x = shape_region_loc.x > region_loc.x;
-			int img_y = Math::posmod(shape_pos.y, region_size);
-			bool next_z = shape_region_loc.y > region_loc.y;
-
-			// Set heights on local map, or adjacent maps if on the last row/col
-			real_t height = 0.f;
-			if (!next_x && !next_z && map.is_valid()) {
-				height = is_hole(cmap->get_pixel(img_x, img_y).r) ? NAN : map->get_pixel(img_x, img_y).r;
-			} else if (next_x && !next_z) {
-				if (map_x.is_valid()) {
-					height = is_hole(cmap_x->get_pixel(img_x, img_y).r) ? NAN : map_x->get_pixel(img_x, img_y).r;
-				} else {
-					height = is_hole(cmap->get_pixel(region_size - 1, img_y).r) ? NAN : map->get_pixel(region_size - 1, img_y).r;
+			int id = row_region + col_region[x];
+			int pixel = row_pixel + col_pixel[x];
+			if (heights[id] == nullptr) {
+				// If there is no region on the last row/col, repeat the previous sample so the
+				// edge of the terrain doesn't drop. Elsewhere leave a hole.
+				int cx = (x == hshape_size - 1) ? x - 1 : x;
+				int cz = (z == hshape_size - 1) ? z - 1 : z;
+				int cy = offset.y + cz * step;
+				id = (cy / region_size) * p_job.region_count.x + col_region[cx];
+				pixel = (cy % region_size) * region_size + col_pixel[cx];
+				if ((cx == x && cz == z) || heights[id] == nullptr) {
+					dst[x * hshape_size] = NAN;
+					holes = true;
+					continue;
 				}
-			} else if (!next_x && next_z) {
-				if (map_z.is_valid()) {
-					height = is_hole(cmap_z->get_pixel(img_x, img_y).r) ? NAN : map_z->get_pixel(img_x, img_y).r;
-				} else {
-					height = (is_hole(cmap->get_pixel(img_x, region_size - 1).r)) ? NAN : map->get_pixel(img_x, region_size - 1).r;
+			}
+			float height = is_hole(controls[id][pixel]) ? NAN : heights[id][pixel];
+			dst[x * hshape_size] = height;
+			// NaN fails both comparisons, so is skipped
+			min_height = std::min(min_height, height);
+			max_height = std::max(max_height, height);
+			holes |= std::isnan(height);
+		}
+	}
+	p_job.min_height = min_height;
+	p_job.max_height = max_height;
+	p_job.holes = holes;
+}
+
+Transform3D Terrain3DCollision::_get_shape_transform(const ShapeJob &p_job) const {
+	// Non rotated shape for normal array index above
+	//Transform3D xform = Transform3D(Basis(), global_pos);
+	// Rotated shape Y=90 for -90 rotated array index, stretched over the lod step
+	int step = 1 << p_job.lod;
+	Basis basis = Basis(Vector3(0, 1.0, 0), Math_PI * .5).scaled(Vector3(step, 1.f, step));
+	return Transform3D(basis, v2iv3(p_job.shape_pos + V2I(p_job.size * step / 2)));
+}
+
+// Runs on WorkerThreadPool threads, so it only touches its own entry in _jobs
+void Terrain3DCollision::_generate_shape_task(const uint32_t p_index) {
+	_extract_heights(_jobs[p_index]);
+}
+
+// Merges generated flat shapes of adjacent cells at the same height into rectangles. The first job
+// of each rectangle gets a box covering it, and the others are marked merged. Jobs of a rectangle,
+// and of any box they replace, are then ordered into units swapped in together, so cells never
+// lose their shape before the box covering them is in place. Full mode only.
+void Terrain3DCollision::_merge_flat_jobs() {
+	int cell_size = _get_full_shape_size();
+	std::map<Vector3i, int> job_cells; // Cell -> job index
+	std::map<Vector3i, int> flat_jobs; // Cell -> job index
+	for (int i = 0; i < _jobs.size(); i++) {
+		Vector3i cell = Vector3i(_jobs[i].shape_pos.x, _jobs[i].shape_pos.y, 0);
+		job_cells[cell] = i;
+		if (_jobs[i].is_flat()) {
+			flat_jobs[cell] = i;
+		}
+	}
+	// Jobs in the same unit share a root
+	std::vector<int> roots(_jobs.size());
+	for (int i = 0; i < roots.size(); i++) {
+		roots[i] = i;
+	}
+	auto find_root = [&](int p_index) -> int {
+		while (roots[p_index] != p_index) {
+			p_index = roots[p_index] = roots[roots[p_index]];
+		}
+		return p_index;
+	};
+	auto join = [&](const int p_a, const int p_b) {
+		int a = find_root(p_a);
+		int b = find_root(p_b);
+		roots[MAX(a, b)] = MIN(a, b);
+	};
+	// Cells covered by an existing box are swapped in with the cell holding it
+	for (const std::pair<const Vector3i, int> &it : job_cells) {
+		auto merged = _merged_cells.find(it.first);
+		if (merged == _merged_cells.end()) {
+			continue;
+		}
+		auto head = job_cells.find(merged->second);
+		if (head != job_cells.end()) {
+			join(it.second, head->second);
+		}
+		_merged_cells.erase(merged);
+		_merge_groups.erase(it.first);
+	}
+
+	auto find_match = [&](const Vector3i &p_cell, const real_t p_height) -> ShapeJob * {
+		auto it = flat_jobs.find(p_cell);
+		if (it == flat_jobs.end()) {
+			return nullptr;
+		}
+		ShapeJob *job = &_jobs[it->second];
+		return (!job->merged && job->merge_count == V2I(1) && job->min_height == p_height) ? job : nullptr;
+	};
+	// Cells are ordered by x, then y. Grow each rectangle along y first, then x.
+	for (const std::pair<const Vector3i, int> &it : flat_jobs) {
+		ShapeJob &job = _jobs[it.second];
+		if (job.merged) {
+			continue;
+		}
+		const Vector3i &cell = it.first;
+		Vector2i count = V2I(1);
+		while (find_match(cell + Vector3i(0, count.y * cell_size, 0), job.min_height)) {
+			count.y++;
+		}
+		while (true) {
+			bool match = true;
+			for (int y = 0; y < count.y && match; y++) {
+				match = find_match(cell + Vector3i(count.x * cell_size, y * cell_size, 0), job.min_height) != nullptr;
+			}
+			if (!match) {
+				break;
+			}
+			count.x++;
+		}
+		if (count == V2I(1)) {
+			continue;
+		}
+		LOG(DEBUG, "Merging ", count.x * count.y, " flat shapes at ", cell, " into one, height: ", job.min_height);
+		for (int i = 0; i < count.x * count.y; i++) {
+			Vector3i member = cell + Vector3i(i % count.x * cell_size, i / count.x * cell_size, 0);
+			_merged_cells[member] = cell;
+			if (i > 0) {
+				_jobs[flat_jobs[member]].merged = true;
+				join(it.second, flat_jobs[member]);
+			}
+		}
+		job.merge_count = count;
+		_merge_groups[cell] = count;
+	}
+
+	// Keep the order of the first job of each unit. Within a unit, boxes go before the cells they cover.
+	std::vector<int> order(_jobs.size());
+	for (int i = 0; i < order.size(); i++) {
+		order[i] = i;
+		_jobs[i].unit = find_root(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](const int p_a, const int p_b) {
+		const ShapeJob &a = _jobs[p_a];
+		const ShapeJob &b = _jobs[p_b];
+		return (a.unit != b.unit) ? a.unit < b.unit : (!a.merged && b.merged);
+	});
+	std::vector<ShapeJob> jobs;
+	jobs.reserve(_jobs.size());
+	for (const int index : order) {
+		jobs.push_back(std::move(_jobs[index]));
+	}
+	_jobs.swap(jobs);
+}
+
+void Terrain3DCollision::_dispatch_jobs() {
+	_jobs_applied = 0;
+	if (_jobs.empty()) {
+		return;
+	}
+	LOG(EXTREME, "Generating ", _jobs.size(), " shapes on worker threads");
+	_job_start_time = Time::get_singleton()->get_ticks_usec();
+	_job_group_id = WorkerThreadPool::get_singleton()->add_group_task(callable_mp(this, &Terrain3DCollision::_generate_shape_task),
+			_jobs.size(), -1, true, "Terrain3D collision shapes");
+}
+
+// Waits for the current batch of shapes to finish generating
+void Terrain3DCollision::_finish_jobs() {
+	if (_job_group_id < 0) {
+		return;
+	}
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(_job_group_id);
+	_job_group_id = -1;
+	LOG(EXTREME, "Generated ", _jobs.size(), " shapes in ", Time::get_singleton()->get_ticks_usec() - _job_start_time, " us");
+	if (_initialized && !is_dynamic_mode()) {
+		_merge_flat_jobs();
+	}
+}
+
+// Gets the instance id of each active region by location
+void Terrain3DCollision::_get_region_ids(std::map<Vector2i, uint64_t> &r_regions) const {
+	Terrain3DData *data = _terrain->get_data();
+	TypedArray<Vector2i> region_locs = data->get_region_locations();
+	r_regions.clear();
+	for (int i = 0; i < region_locs.size(); i++) {
+		Vector2i region_loc = region_locs[i];
+		const Terrain3DRegion *region = data->get_region_ptr(region_loc);
+		if (region && !region->is_deleted()) {
+			r_regions[region_loc] = region->get_instance_id();
+		}
+	}
+}
+
+// Full mode. Adds the region to r_regions, along with the regions covered by each merged box that
+// overlaps it, and so on for those regions.
+void Terrain3DCollision::_get_group_regions(const Vector2i &p_region_loc, std::set<Vector2i> &r_regions) const {
+	int region_size = _terrain->get_region_size();
+	int cell_size = _get_full_shape_size();
+	std::vector<Vector2i> regions = { p_region_loc };
+	r_regions.insert(p_region_loc);
+	while (!regions.empty()) {
+		Rect2i bounds = Rect2i(regions.back() * region_size, V2I(region_size));
+		regions.pop_back();
+		for (const std::pair<const Vector3i, Vector2i> &group : _merge_groups) {
+			Rect2i rect = Rect2i(Vector2i(group.first.x, group.first.y), group.second * cell_size);
+			if (!rect.intersects(bounds)) {
+				continue;
+			}
+			Vector2i first = rect.position;
+			Vector2i last = rect.get_end() - V2I(1);
+			first = V2I_DIVIDE_FLOOR(first, region_size);
+			last = V2I_DIVIDE_FLOOR(last, region_size);
+			for (int y = first.y; y <= last.y; y++) {
+				for (int x = first.x; x <= last.x; x++) {
+					if (r_regions.insert(Vector2i(x, y)).second) {
+						regions.push_back(Vector2i(x, y));
+					}
 				}
-			} else if (next_x && next_z) {
-				if (map_xz.is_valid()) {
-					height = is_hole(cmap_xz->get_pixel(img_x, img_y).r) ? NAN : map_xz->get_pixel(img_x, img_y).r;
-				} else {
-					height = (is_hole(cmap->get_pixel(region_size - 1, region_size - 1).r)) ? NAN : map->get_pixel(region_size - 1, region_size - 1).r;
+			}
+		}
+	}
+}
+
+// Full mode. Queues the region to be rebuilt, along with those sharing merged boxes with it.
+// Locations with no region that were never built are skipped.
+void Terrain3DCollision::_queue_region(const Vector2i &p_region_loc) {
+	Terrain3DData *data = _terrain->get_data();
+	std::set<Vector2i> regions;
+	_get_group_regions(p_region_loc, regions);
+	regions.erase(p_region_loc);
+	std::vector<Vector2i> queue = { p_region_loc };
+	queue.insert(queue.end(), regions.begin(), regions.end());
+	for (const Vector2i &region_loc : queue) {
+		const Terrain3DRegion *region = data->get_region_ptr(region_loc);
+		if ((!region || region->is_deleted()) && _built_regions.count(region_loc) == 0) {
+			continue;
+		}
+		if (std::find(_pending_regions.begin(), _pending_regions.end(), region_loc) == _pending_regions.end()) {
+			_pending_regions.push_back(region_loc);
+			_regions_total++;
+		}
+	}
+}
+
+// Full mode. Removes the shapes of a region that no longer exists. Merged boxes of neighbors that
+// reach into it remain until the caller rebuilds those regions.
+void Terrain3DCollision::_remove_region(const Vector2i &p_region_loc) {
+	LOG(DEBUG, "Removing collision of region ", p_region_loc);
+	int region_size = _terrain->get_region_size();
+	Rect2i bounds = Rect2i(p_region_loc * region_size, V2I(region_size));
+	for (auto it = _cell_shapes.begin(); it != _cell_shapes.end();) {
+		if (!bounds.has_point(Vector2i(it->first.x, it->first.y))) {
+			++it;
+			continue;
+		}
+		_merged_cells.erase(it->first);
+		_merge_groups.erase(it->first);
+		if (it->second >= 0) {
+			_release_shape(it->second);
+		}
+		it = _cell_shapes.erase(it);
+	}
+	_built_regions.erase(p_region_loc);
+}
+
+// Full mode. Starts generating the shapes of the next few pending regions. Regions sharing merged
+// boxes are taken into the same batch, so their cells are swapped in together.
+void Terrain3DCollision::_dispatch_regions() {
+	Terrain3DData *data = _terrain->get_data();
+	int region_size = _terrain->get_region_size();
+	int shape_size = _get_full_shape_size();
+	std::vector<Vector2i> batch;
+	while (!_pending_regions.empty() && int(batch.size()) < FULL_BATCH_REGIONS) {
+		Vector2i region_loc = _pending_regions.front();
+		_pending_regions.pop_front();
+		batch.push_back(region_loc);
+		std::set<Vector2i> regions;
+		_get_group_regions(region_loc, regions);
+		for (const Vector2i &group_loc : regions) {
+			auto it = std::find(_pending_regions.begin(), _pending_regions.end(), group_loc);
+			if (it != _pending_regions.end()) {
+				_pending_regions.erase(it);
+				batch.push_back(group_loc);
+			}
+		}
+	}
+	for (const Vector2i &region_loc : batch) {
+		_regions_built++;
+		const Terrain3DRegion *region = data->get_region_ptr(region_loc);
+		if (!region || region->is_deleted()) {
+			_remove_region(region_loc);
+			continue;
+		}
+		_built_regions[region_loc] = region->get_instance_id();
+		for (int y = 0; y < region_size; y += shape_size) {
+			for (int x = 0; x < region_size; x += shape_size) {
+				Vector3i cell = Vector3i(region_loc.x * region_size + x, region_loc.y * region_size + y, 0);
+				ShapeJob job;
+				if (_init_job(job, cell, shape_size)) {
+					_jobs.push_back(job);
 				}
 			}
-			map_data[index] = height;
-			if (!std::isnan(height)) {
-				min_height = MIN(min_height, height);
-				max_height = MAX(max_height, height);
+		}
+	}
+	LOG(EXTREME, "Regions built: ", _regions_built, "/", _regions_total, ", jobs: ", _jobs.size());
+	_dispatch_jobs();
+}
+
+// Swaps up to p_limit generated shapes into place. Returns true once all jobs are applied.
+bool Terrain3DCollision::_apply_jobs(const int p_limit) {
+	real_t spacing = _terrain->get_vertex_spacing();
+	int applied = 0;
+	int unit = -1;
+	for (; _jobs_applied < _jobs.size(); _jobs_applied++) {
+		ShapeJob &job = _jobs[_jobs_applied];
+		// Past the limit, finish the unit in progress, so merged cells are covered in the same frame
+		if (applied >= p_limit && (job.unit < 0 || job.unit != unit)) {
+			break;
+		}
+		unit = job.unit;
+		Vector3i cell = Vector3i(job.shape_pos.x, job.shape_pos.y, job.lod);
+		auto it = _cell_shapes.find(cell);
+		int shape_id = (it != _cell_shapes.end()) ? it->second : -1;
+		if (it == _cell_shapes.end() && is_dynamic_mode() && _cell_refs.count(cell) == 0) {
+			LOG(EXTREME, "Cell ", cell, " left the area before its shape was placed. Skipping");
+			job = ShapeJob();
+			continue;
+		}
+		// Fully holed cells and those covered by a merged neighbor need no shape
+		if (job.merged || job.min_height > job.max_height) {
+			LOG(EXTREME, "Cell ", cell, " needs no shape");
+			if (shape_id >= 0) {
+				_release_shape(shape_id);
 			}
+			_cell_shapes[cell] = -1;
+			job = ShapeJob();
+			continue;
 		}
+		// Regenerated cells keep their shape
+		if (shape_id < 0) {
+			shape_id = _take_shape();
+			if (_shape_cells[shape_id] != V3I_MAX) {
+				_cell_shapes.erase(_shape_cells[shape_id]);
+			}
+			_shape_cells[shape_id] = cell;
+			_cell_shapes[cell] = shape_id;
+		}
+		if (job.is_flat()) {
+			// A thin box with its top at the height, over the cell or merged rectangle
+			Vector2i span = V2I(job.size << job.lod) * job.merge_count;
+			Vector3 half_extents = Vector3(span.x * spacing, FLAT_DEPTH, span.y * spacing) * .5f;
+			Vector3 center = Vector3((job.shape_pos.x + span.x * .5f) * spacing, job.min_height - FLAT_DEPTH * .5f,
+					(job.shape_pos.y + span.y * .5f) * spacing);
+			LOG(EXTREME, "Placing flat shape id ", shape_id, " at ", job.shape_pos, ", lod ", job.lod, ", cells: ", job.merge_count);
+			_shape_set_box(shape_id, half_extents);
+			_shape_set_transform(shape_id, Transform3D(Basis(), center));
+		} else {
+			Transform3D xform = _get_shape_transform(job);
+			LOG(EXTREME, "Placing shape id ", shape_id, " at ", job.shape_pos, ", lod ", job.lod);
+			xform.scale(Vector3(spacing, 1.f, spacing));
+			Dictionary shape_data;
+			shape_data["width"] = job.size + 1;
+			shape_data["depth"] = job.size + 1;
+			shape_data["heights"] = job.map_data;
+			shape_data["min_height"] = job.min_height;
+			shape_data["max_height"] = job.max_height;
+			_shape_set_data(shape_id, shape_data);
+			_shape_set_transform(shape_id, xform);
+		}
+		_shape_set_disabled(shape_id, false);
+		job = ShapeJob(); // Release the map data
+		applied++;
+	}
+	if (_jobs_applied < _jobs.size()) {
+		return false;
 	}
+	_jobs.clear();
+	_jobs_applied = 0;
+	return true;
+}
 
-	// Non rotated shape for normal array index above
-	//Transform3D xform = Transform3D(Basis(), global_pos);
-	// Rotated shape Y=90 for -90 rotated array index
-	Transform3D xform = Transform3D(Basis(Vector3(0, 1.0, 0), Math_PI * .5), v2iv3(p_position + V2I(p_size / 2)));
-	Dictionary shape_data;
-	shape_data["width"] = hshape_size;
-	shape_data["depth"] = hshape_size;
-	shape_data["heights"] = map_data;
-	shape_data["xform"] = xform;
-	shape_data["min_height"] = min_height;
-	shape_data["max_height"] = max_height;
-	return shape_data;
+// Creates a disabled, out of sight shape and returns its id
+int Terrain3DCollision::_add_shape() {
+	int shape_id = _shape_cells.size();
+	int hshape_size = (is_dynamic_mode() ? _shape_size : _get_full_shape_size()) + 1;
+	Transform3D xform(Basis(), V3_MAX);
+	if (is_editor_mode()) {
+		CollisionShape3D *col_shape = memnew(CollisionShape3D);
+		_shapes.push_back(col_shape);
+		col_shape->set_name("CollisionShape3D");
+		col_shape->set_disabled(true);
+		col_shape->set_visible(true);
+		Ref<HeightMapShape3D> hshape;
+		hshape.instantiate();
+		hshape->set_map_width(hshape_size);
+		hshape->set_map_depth(hshape_size);
+		col_shape->set_shape(hshape);
+		_static_body->add_child(col_shape, true);
+		col_shape->set_owner(_static_body);
+		col_shape->set_transform(xform);
+	} else {
+		RID shape_rid = PS->heightmap_shape_create();
+		PS->body_add_shape(_static_body_rid, shape_rid, xform, true);
+		_spare_shape_rids.push_back(RID());
+		LOG(DEBUG, "Adding shape: ", shape_id, ", rid: ", shape_rid.get_id());
+	}
+	_shape_cells.push_back(V3I_MAX);
+	return shape_id;
+}
+
+// Returns an unused shape, or else the farthest shape of a cell outside the area, or else a new one
+int Terrain3DCollision::_take_shape() {
+	std::vector<int> &shapes = _free_shapes.empty() ? _retired_shapes : _free_shapes;
+	if (shapes.empty()) {
+		LOG(EXTREME, "All ", _shape_cells.size(), " shapes in use, adding another");
+		return _add_shape();
+	}
+	int shape_id = shapes.back();
+	shapes.pop_back();
+	return shape_id;
+}
+
+// Disables the shape and returns it to the unused shapes. The caller updates _cell_shapes.
+void Terrain3DCollision::_release_shape(const int p_shape_id) {
+	_shape_set_disabled(p_shape_id, true);
+	_shape_cells[p_shape_id] = V3I_MAX;
+	_retired_shapes.erase(std::remove(_retired_shapes.begin(), _retired_shapes.end(), p_shape_id), _retired_shapes.end());
+	_free_shapes.push_back(p_shape_id);
+}
+
+// Drops the references of the focus point to its cells. Shapes of cells no longer referenced are
+// retired on the next update.
+void Terrain3DCollision::_release_cells(FocusPoint &p_focus) {
+	for (const Vector3i &cell : p_focus.cells) {
+		auto it = _cell_refs.find(cell);
+		if (it != _cell_refs.end() && --it->second <= 0) {
+			_cell_refs.erase(it);
+		}
+	}
+	p_focus.cells.clear();
+	p_focus.snapped_pos = V2I_MAX;
+	p_focus.predicted_pos = V2I_MAX;
+}
+
+// Returns the cells within the radius of the path between the snapped, descaled positions. With
+// no movement predicted, the path is a point and the area a ring. Cells of the outermost ring are
+// aligned to their size. Those near the ring within are split into four, down to lod 0.
+void Terrain3DCollision::_get_ring_cells(const Vector2i &p_from, const Vector2i &p_to, const int p_radius, std::vector<Vector3i> &r_cells) const {
+	r_cells.clear();
+	int lod = _lods - 1;
+	int cell_size = _shape_size << lod;
+	int radius = p_radius << lod;
+	Vector2i grid_start = Vector2i(MIN(p_from.x, p_to.x), MIN(p_from.y, p_to.y)) - V2I(radius);
+	Vector2i grid_end = Vector2i(MAX(p_from.x, p_to.x), MAX(p_from.y, p_to.y)) + V2I(radius);
+	grid_start = V2I_DIVIDE_FLOOR(grid_start, cell_size) * cell_size;
+	grid_end = V2I_DIVIDE_FLOOR(grid_end, cell_size) * cell_size;
+	LOG(EXTREME, "Path: ", p_from, " to ", p_to, ", radius: ", p_radius, ", lods: ", _lods, ", outer grid: ", grid_start, " to ", grid_end);
+	for (int y = grid_start.y; y <= grid_end.y; y += cell_size) {
+		for (int x = grid_start.x; x <= grid_end.x; x += cell_size) {
+			Vector2i center = Vector2i(x, y) + V2I(cell_size / 2);
+			if (_path_distance(center, p_from, p_to) <= real_t(radius)) {
+				_add_ring_cell(Vector3i(x, y, lod), p_from, p_to, p_radius, r_cells);
+			}
+		}
+	}
+}
+
+// Adds the cell, or its four quarters if its center is within the radius of the next finer lod
+void Terrain3DCollision::_add_ring_cell(const Vector3i &p_cell, const Vector2i &p_from, const Vector2i &p_to, const int p_radius, std::vector<Vector3i> &r_cells) const {
+	int lod = p_cell.z;
+	int half_size = (_shape_size << lod) / 2;
+	Vector2i center = Vector2i(p_cell.x + half_size, p_cell.y + half_size);
+	if (lod == 0 || _path_distance(center, p_from, p_to) > real_t(p_radius << (lod - 1))) {
+		r_cells.push_back(p_cell);
+		return;
+	}
+	for (int i = 0; i < 4; i++) {
+		_add_ring_cell(Vector3i(p_cell.x + (i & 1) * half_size, p_cell.y + (i >> 1) * half_size, lod - 1), p_from, p_to, p_radius, r_cells);
+	}
+}
+
+// Updates the camera focus position, and estimates the velocity of focus points not given one
+// from their movement since the last call. Terrain3D calls update() every physics frame, so this
+// samples each frame. After a longer gap, such as while the tree was paused, estimates restart.
+void Terrain3DCollision::_track_focus_points() {
+	if (_camera_focus) {
+		_focus_points[0].position = _terrain->get_snapped_position();
+	}
+	uint64_t now = Time::get_singleton()->get_ticks_usec();
+	for (std::pair<const int, FocusPoint> &it : _focus_points) {
+		FocusPoint &focus = it.second;
+		if (!focus.velocity_set && focus.last_time > 0 && now > focus.last_time) {
+			if (now - focus.last_time > VELOCITY_MAX_GAP) {
+				focus.velocity = V3_ZERO;
+			} else {
+				Vector3 velocity = (focus.position - focus.last_position) / (real_t(now - focus.last_time) * 1e-6f);
+				focus.velocity = focus.velocity.lerp(velocity, VELOCITY_SMOOTHING);
+			}
+		}
+		focus.last_position = focus.position;
+		focus.last_time = now;
+	}
 }
 
 void Terrain3DCollision::_shape_set_disabled(const int p_shape_id, const bool p_disabled) {
@@ -138,26 +632,70 @@ void Terrain3DCollision::_shape_set_transform(const int p_shape_id, const Transf
 	}
 }
 
-Vector3 Terrain3DCollision::_shape_get_position(const int p_shape_id) const {
-	if (is_editor_mode()) {
-		CollisionShape3D *shape = _shapes[p_shape_id];
-		return shape->get_global_position();
-	} else {
-		return PS->body_get_shape_transform(_static_body_rid, p_shape_id).origin;
+// Swaps the shape in the body for the spare one if it isn't of the given type, creating the spare
+// if needed. Returns the shape now in the body. Physics server only.
+RID Terrain3DCollision::_shape_swap_type(const int p_shape_id, const PhysicsServer3D::ShapeType p_type) {
+	RID shape_rid = PS->body_get_shape(_static_body_rid, p_shape_id);
+	if (PS->shape_get_type(shape_rid) == p_type) {
+		return shape_rid;
 	}
+	RID spare_rid = _spare_shape_rids[p_shape_id];
+	if (!spare_rid.is_valid()) {
+		spare_rid = (p_type == PhysicsServer3D::SHAPE_BOX) ? PS->box_shape_create() : PS->heightmap_shape_create();
+	}
+	PS->body_set_shape(_static_body_rid, p_shape_id, spare_rid);
+	if (PS->shape_get_type(shape_rid) == PhysicsServer3D::SHAPE_HEIGHTMAP) {
+		// Release the heights while it's unused
+		PackedFloat32Array heights;
+		heights.resize(4);
+		heights.fill(0.f);
+		Dictionary shape_data;
+		shape_data["width"] = 2;
+		shape_data["depth"] = 2;
+		shape_data["heights"] = heights;
+		shape_data["min_height"] = 0.f;
+		shape_data["max_height"] = 0.f;
+		PS->shape_set_data(shape_rid, shape_data);
+	}
+	_spare_shape_rids[p_shape_id] = shape_rid;
+	return spare_rid;
 }
 
 void Terrain3DCollision::_shape_set_data(const int p_shape_id, const Dictionary &p_dict) {
 	if (is_editor_mode()) {
 		CollisionShape3D *shape = _shapes[p_shape_id];
 		Ref<HeightMapShape3D> hshape = shape->get_shape();
+		if (hshape.is_null()) {
+			hshape.instantiate();
+			shape->set_shape(hshape);
+		}
+		int width = p_dict["width"];
+		if (hshape->get_map_width() != width || hshape->get_map_depth() != width) {
+			hshape->set_map_width(width);
+			hshape->set_map_depth(width);
+		}
 		hshape->set_map_data(p_dict["heights"]);
 	} else {
-		RID shape_rid = PS->body_get_shape(_static_body_rid, p_shape_id);
+		RID shape_rid = _shape_swap_type(p_shape_id, PhysicsServer3D::SHAPE_HEIGHTMAP);
 		PS->shape_set_data(shape_rid, p_dict);
 	}
 }
 
+void Terrain3DCollision::_shape_set_box(const int p_shape_id, const Vector3 &p_half_extents) {
+	if (is_editor_mode()) {
+		CollisionShape3D *shape = _shapes[p_shape_id];
+		Ref<BoxShape3D> box = shape->get_shape();
+		if (box.is_null()) {
+			box.instantiate();
+			shape->set_shape(box);
+		}
+		box->set_size(p_half_extents * 2.f);
+	} else {
+		RID shape_rid = _shape_swap_type(p_shape_id, PhysicsServer3D::SHAPE_BOX);
+		PS->shape_set_data(shape_rid, p_half_extents);
+	}
+}
+
 ///////////////////////////
 // Public Functions
 ///////////////////////////
@@ -215,14 +753,15 @@ void Terrain3DCollision::build() {
 	int shape_count;
 	int hshape_size;
 	if (is_dynamic_mode()) {
-		int grid_width = _radius * 2 / _shape_size;
-		grid_width = int_ceil_pow2(grid_width, 4);
-		shape_count = grid_width * grid_width;
+		// Enough for one ring. More are added as other focus points need them.
+		std::vector<Vector3i> cells;
+		_get_ring_cells(V2I_ZERO, V2I_ZERO, _radius, cells);
+		shape_count = cells.size();
 		hshape_size = _shape_size + 1;
-		LOG(DEBUG, "Grid width: ", grid_width);
 	} else {
-		shape_count = _terrain->get_data()->get_region_count();
-		hshape_size = _terrain->get_region_size() + 1;
+		// Added as regions are built, as flat and fully holed areas need fewer
+		shape_count = 0;
+		hshape_size = _get_full_shape_size() + 1;
 	}
 	// Preallocate memory for push_back()
 	if (is_editor_mode()) {
@@ -230,31 +769,35 @@ void Terrain3DCollision::build() {
 	}
 	LOG(DEBUG, "Shape count: ", shape_count);
 	LOG(DEBUG, "Shape size: ", _shape_size, ", hshape_size: ", hshape_size);
-	Transform3D xform(Basis(), V3_MAX);
+	_shape_cells.reserve(shape_count);
 	for (int i = 0; i < shape_count; i++) {
-		if (is_editor_mode()) {
-			CollisionShape3D *col_shape = memnew(CollisionShape3D);
-			_shapes.push_back(col_shape);
-			col_shape->set_name("CollisionShape3D");
-			col_shape->set_disabled(true);
-			col_shape->set_visible(true);
-			Ref<HeightMapShape3D> hshape;
-			hshape.instantiate();
-			hshape->set_map_width(hshape_size);
-			hshape->set_map_depth(hshape_size);
-			col_shape->set_shape(hshape);
-			_static_body->add_child(col_shape, true);
-			col_shape->set_owner(_static_body);
-			col_shape->set_transform(xform);
-		} else {
-			RID shape_rid = PS->heightmap_shape_create();
-			PS->body_add_shape(_static_body_rid, shape_rid, xform, true);
-			LOG(DEBUG, "Adding shape: ", i, ", rid: ", shape_rid.get_id(), " pos: ", _shape_get_position(i));
-		}
+		_add_shape();
+	}
+	_free_shapes.resize(shape_count);
+	for (int i = 0; i < shape_count; i++) {
+		_free_shapes[i] = shape_count - 1 - i; // Lowest id last
 	}
-
 	_initialized = true;
-	update();
+	if (is_dynamic_mode()) {
+		// Collision is needed right away, so the first shapes are generated before returning
+		_get_region_ids(_built_regions);
+		update(true);
+	} else {
+		// Regions are built over the following frames, nearest to the camera first
+		Vector2i camera_region = _terrain->get_data()->get_region_location(_terrain->get_snapped_position());
+		TypedArray<Vector2i> region_locs = _terrain->get_data()->get_region_locations();
+		std::vector<Vector2i> locations;
+		for (int i = 0; i < region_locs.size(); i++) {
+			locations.push_back(region_locs[i]);
+		}
+		std::sort(locations.begin(), locations.end(), [&](const Vector2i &p_a, const Vector2i &p_b) {
+			return p_a.distance_squared_to(camera_region) < p_b.distance_squared_to(camera_region);
+		});
+		for (const Vector2i &region_loc : locations) {
+			_queue_region(region_loc);
+		}
+		update();
+	}
 }
 
 void Terrain3DCollision::update(const bool p_force) {
@@ -263,132 +806,316 @@ void Terrain3DCollision::update(const bool p_force) {
 	}
 	if (p_force && !is_dynamic_mode()) {
 		build();
-		return;
+		if (!_initialized) {
+			return;
+		}
 	}
 	int time = Time::get_singleton()->get_ticks_usec();
 	real_t spacing = _terrain->get_vertex_spacing();
 
 	if (is_dynamic_mode()) {
-		// Snap descaled position to a _shape_size grid (eg. multiples of 16)
-		Vector2i snapped_pos = _snap_to_grid(_terrain->get_snapped_position() / spacing);
-		LOG(EXTREME, "Updating collision at ", snapped_pos);
+		// Follow focus points every call, even while a batch is in flight
+		_track_focus_points();
 
-		// Skip if location hasn't moved to next step
-		if (!p_force && (_last_snapped_pos - snapped_pos).length() < _shape_size) {
+		// Swap in the shapes of the last batch first. Forced updates finish it right away.
+		if (_job_group_id >= 0) {
+			if (!p_force && !WorkerThreadPool::get_singleton()->is_group_task_completed(_job_group_id)) {
+				return;
+			}
+			_finish_jobs();
+		}
+		if (!_apply_jobs(p_force ? INT32_MAX : APPLY_LIMIT)) {
+			LOG(EXTREME, "Applied shapes, ", _jobs.size() - _jobs_applied, " remaining. Collision update time: ", Time::get_singleton()->get_ticks_usec() - time, " us");
 			return;
 		}
 
-		LOG(EXTREME, "---- 1. Defining area as a radius on a grid ----");
-		// Create a 0-N grid, center on snapped_pos
-		PackedInt32Array grid;
-		int grid_width = _radius * 2 / _shape_size; // 64*2/16 = 8
-		grid_width = int_ceil_pow2(grid_width, 4);
-		grid.resize(grid_width * grid_width);
-		grid.fill(-1);
-		Vector2i grid_offset = -V2I(grid_width / 2); // offset # cells to center of grid
-		Vector2i shape_offset = V2I(_shape_size / 2); // offset meters to top left corner of shape
-		Vector2i grid_pos = snapped_pos + grid_offset * _shape_size; // Top left of grid
-		LOG(EXTREME, "New Snapped position: ", snapped_pos);
-		LOG(EXTREME, "Grid_pos: ", grid_pos);
-		LOG(EXTREME, "Radius: ", _radius, ", Grid_width: ", grid_width, ", Grid_offset: ", grid_offset, ", # cells: ", grid.size());
-		LOG(EXTREME, "Shape_size: ", _shape_size, ", shape_offset: ", shape_offset);
-
-		LOG(EXTREME, "---- 2. Checking existing shapes ----");
-		// If shape is within area, skip
-		// Else, mark unused
-
-		// Stores index into _shapes array
-		TypedArray<int> inactive_shape_ids;
-
-		int shape_count = is_editor_mode() ? _shapes.size() : PS->body_get_shape_count(_static_body_rid);
-		for (int i = 0; i < shape_count; i++) {
-			// Descaled global position of shape center
-			Vector3 shape_center = _shape_get_position(i) / spacing;
-			// Unique key: Top left corner of shape, snapped to grid
-			Vector2i shape_pos = _snap_to_grid(v3v2i(shape_center) - shape_offset);
-			// Optionally could adjust radius to account for corner (sqrt(_shape_size*2))
-			if (!p_force && (shape_center.x < FLT_MAX && v3v2i(shape_center).distance_to(snapped_pos) <= real_t(_radius))) {
-				// Get index into shape array
-				Vector2i grid_loc = (shape_pos - grid_pos) / _shape_size;
-				grid[grid_loc.y * grid_width + grid_loc.x] = i;
-				_shape_set_disabled(i, false);
-				LOG(EXTREME, "Shape ", i, ": shape_center: ", shape_center.x < FLT_MAX ? shape_center : V3(-999), ", shape_pos: ", shape_pos,
-						", grid_loc: ", grid_loc, ", index: ", (grid_loc.y * grid_width + grid_loc.x), " active");
-			} else {
-				inactive_shape_ids.push_back(i);
-				_shape_set_disabled(i, true);
-				LOG(EXTREME, "Shape ", i, ": shape_center: ", shape_center.x < FLT_MAX ? shape_center : V3(-999), ", shape_pos: ", shape_pos,
-						" out of bounds, marking inactive");
+		LOG(EXTREME, "---- 1. Defining area as radii on a grid around each focus point ----");
+		std::vector<Vector2i> centers;
+		std::vector<Vector3i> new_cells;
+		std::vector<Vector3i> cells;
+		for (std::pair<const int, FocusPoint> &it : _focus_points) {
+			FocusPoint &focus = it.second;
+			// Snap descaled position to a _shape_size grid (eg. multiples of 16)
+			Vector2i snapped_pos = _snap_to_grid(focus.position / spacing);
+			centers.push_back(snapped_pos);
+			int radius = MAX(focus.radius > 0 ? focus.radius : _radius, _shape_size + 8);
+			// Extend the area along the predicted path, no more than a few outer radii ahead
+			Vector3 lead = focus.velocity * _prediction_time / spacing;
+			lead.y = 0.f;
+			lead = lead.limit_length(real_t(radius << (_lods - 1)) * MAX_LEAD_RADII);
+			Vector2i predicted_pos = _snap_to_grid(focus.position / spacing + lead);
+			// Skip if location hasn't moved to next step
+			if (!p_force && focus.snapped_pos != V2I_MAX && (focus.snapped_pos - snapped_pos).length() < _shape_size &&
+					(focus.predicted_pos - predicted_pos).length() < _shape_size) {
+				continue;
 			}
+			LOG(EXTREME, "Updating collision of focus point ", it.first, " at ", snapped_pos, ", predicted: ", predicted_pos);
+			_get_ring_cells(snapped_pos, predicted_pos, radius, cells);
+			// Reference the new cells before releasing the old, so cells in both keep their shapes
+			for (const Vector3i &cell : cells) {
+				if (_cell_refs[cell]++ == 0) {
+					new_cells.push_back(cell);
+				}
+			}
+			_release_cells(focus);
+			focus.cells.swap(cells);
+			focus.snapped_pos = snapped_pos;
+			focus.predicted_pos = predicted_pos;
+			_focus_changed = true;
 		}
-		LOG(EXTREME, "_inactive_shapes size: ", inactive_shape_ids.size());
-
-		LOG(EXTREME, "---- 3. Review grid cells in area ----");
-		// If cell is full, skip
-		// Else assign shape and form it
-
-		for (int i = 0; i < grid.size(); i++) {
-			Vector2i grid_loc(i % grid_width, i / grid_width);
-			// Unique key: Top left corner of shape, snapped to grid
-			Vector2i shape_pos = grid_pos + grid_loc * _shape_size;
+		if (!p_force && !_focus_changed) {
+			return;
+		}
+		_focus_changed = false;
 
-			if ((shape_pos + shape_offset).distance_to(snapped_pos) > real_t(_radius)) {
-				LOG(EXTREME, "grid[", i, ":", grid_loc, "] shape_pos : ", shape_pos, " out of circle, skipping");
+		LOG(EXTREME, "---- 2. Review grid cells in area ----");
+		// If cell has a shape and its regions haven't changed, keep it
+		// Else queue a job to generate one
+		if (p_force) {
+			new_cells.clear();
+			for (const std::pair<const Vector3i, int> &cell : _cell_refs) {
+				new_cells.push_back(cell.first);
+			}
+		}
+		new_cells.insert(new_cells.end(), _stale_cells.begin(), _stale_cells.end());
+		std::set<Vector3i> queued;
+		for (const Vector3i &cell : new_cells) {
+			if (_cell_refs.count(cell) == 0 || !queued.insert(cell).second) {
 				continue;
 			}
-			if (!p_force && grid[i] >= 0) {
-				Vector2i center_pos = v3v2i(_shape_get_position(i));
-				LOG(EXTREME, "grid[", i, ":", grid_loc, "] shape_pos : ", shape_pos, " act ", center_pos - shape_offset, " Has active shape id: ", grid[i]);
+			bool stale = _stale_cells.count(cell) > 0;
+			if (!p_force && !stale && _cell_shapes.count(cell) > 0) {
+				LOG(EXTREME, "Cell ", cell, " has active shape id: ", _cell_shapes[cell]);
 				continue;
-			} else {
-				if (inactive_shape_ids.size() == 0) {
-					LOG(ERROR, "No more unused shapes! Aborting!");
-					break;
-				}
-				Dictionary shape_data = _get_shape_data(shape_pos, _shape_size);
-				if (shape_data.is_empty()) {
-					LOG(EXTREME, "grid[", i, ":", grid_loc, "] shape_pos : ", shape_pos, " No region found");
-					continue;
+			}
+			ShapeJob job;
+			if (_init_job(job, cell, _shape_size)) {
+				_jobs.push_back(job);
+			} else if (stale) {
+				// Its regions were removed
+				auto it = _cell_shapes.find(cell);
+				if (it != _cell_shapes.end()) {
+					if (it->second >= 0) {
+						_release_shape(it->second);
+					}
+					_cell_shapes.erase(it);
 				}
-				int shape_id = inactive_shape_ids.pop_back();
-				Transform3D xform = shape_data["xform"];
-				LOG(EXTREME, "grid[", i, ":", grid_loc, "] shape_pos : ", shape_pos, " act ", v3v2i(xform.origin) - shape_offset, " placing shape id ", shape_id);
-				xform.scale(Vector3(spacing, 1.f, spacing));
-				_shape_set_transform(shape_id, xform);
-				_shape_set_disabled(shape_id, false);
-				_shape_set_data(shape_id, shape_data);
 			}
 		}
-		_last_snapped_pos = snapped_pos;
-		LOG(EXTREME, "Setting _last_snapped_pos: ", _last_snapped_pos);
-		LOG(EXTREME, "inactive_shape_ids size: ", inactive_shape_ids.size());
+		_stale_cells.clear();
+		// Swap in shapes nearest to a focus point first. Those along the predicted paths follow
+		// over the next frames, ahead of arrival.
+		std::vector<std::pair<int64_t, int>> job_order;
+		job_order.reserve(_jobs.size());
+		for (int i = 0; i < _jobs.size(); i++) {
+			Vector2i center = _jobs[i].shape_pos + V2I((_shape_size << _jobs[i].lod) / 2);
+			int64_t distance = INT64_MAX;
+			for (const Vector2i &focus_pos : centers) {
+				distance = MIN(distance, center.distance_squared_to(focus_pos));
+			}
+			job_order.push_back({ distance, i });
+		}
+		std::sort(job_order.begin(), job_order.end());
+		std::vector<ShapeJob> jobs;
+		jobs.reserve(_jobs.size());
+		for (const std::pair<int64_t, int> &order : job_order) {
+			jobs.push_back(std::move(_jobs[order.second]));
+		}
+		_jobs.swap(jobs);
+
+		LOG(EXTREME, "---- 3. Retire shapes outside of area ----");
+		// They keep colliding until reused, farthest from any focus point first
+		// Cells outside that needed no shape are forgotten
+		std::vector<std::pair<int64_t, int>> retired;
+		for (auto it = _cell_shapes.begin(); it != _cell_shapes.end();) {
+			if (_cell_refs.count(it->first) > 0) {
+				++it;
+			} else if (it->second < 0) {
+				it = _cell_shapes.erase(it);
+			} else {
+				retired.push_back({ 0, it->second });
+				++it;
+			}
+		}
+		for (std::pair<int64_t, int> &shape : retired) {
+			const Vector3i &cell = _shape_cells[shape.second];
+			Vector2i pos = Vector2i(cell.x, cell.y);
+			shape.first = INT64_MAX;
+			for (const Vector2i &center : centers) {
+				shape.first = MIN(shape.first, pos.distance_squared_to(center));
+			}
+		}
+		std::sort(retired.begin(), retired.end());
+		_retired_shapes.clear();
+		for (const std::pair<int64_t, int> &shape : retired) {
+			_retired_shapes.push_back(shape.second);
+		}
+		LOG(EXTREME, "Focus points: ", _focus_points.size(), ", cells: ", _cell_refs.size(), ", jobs: ", _jobs.size(),
+				", retired shapes: ", _retired_shapes.size(), ", free shapes: ", _free_shapes.size());
+
+		_dispatch_jobs();
+		if (p_force) {
+			_finish_jobs();
+			_apply_jobs(INT32_MAX);
+		}
 
 	} else {
-		// Full collision
-		int shape_count = _terrain->get_data()->get_region_count();
+		// Full collision, generated a few regions at a time on worker threads and swapped in over
+		// the following frames. Forced updates finish all pending regions before returning.
+		do {
+			if (_job_group_id >= 0) {
+				if (!p_force && !WorkerThreadPool::get_singleton()->is_group_task_completed(_job_group_id)) {
+					return;
+				}
+				_finish_jobs();
+			}
+			if (!_apply_jobs(p_force ? INT32_MAX : APPLY_LIMIT)) {
+				return;
+			}
+			if (_regions_total > 0) {
+				emit_signal("build_progress", _regions_built, _regions_total);
+			}
+			if (_pending_regions.empty()) {
+				_regions_built = 0;
+				_regions_total = 0;
+				break;
+			}
+			_dispatch_regions();
+		} while (p_force);
+	}
+	LOG(EXTREME, "Collision update time: ", Time::get_singleton()->get_ticks_usec() - time, " us");
+}
+
+// Called when regions are added, removed or replaced. Only regions that changed are rebuilt, over
+// the following frames. In dynamic mode, cells in the area over them are regenerated.
+void Terrain3DCollision::update_regions() {
+	if (!_initialized) {
+		build();
+		return;
+	}
+	std::map<Vector2i, uint64_t> regions; // Region location -> instance id
+	_get_region_ids(regions);
+	std::vector<Vector2i> removed;
+	std::vector<Vector2i> changed;
+	for (const std::pair<const Vector2i, uint64_t> &built : _built_regions) {
+		if (regions.count(built.first) == 0) {
+			removed.push_back(built.first);
+		}
+	}
+	for (const std::pair<const Vector2i, uint64_t> &region : regions) {
+		auto it = _built_regions.find(region.first);
+		if (it == _built_regions.end() || it->second != region.second) {
+			changed.push_back(region.first);
+		}
+	}
+
+	if (is_dynamic_mode()) {
+		_built_regions.swap(regions);
+		changed.insert(changed.end(), removed.begin(), removed.end());
+		if (changed.empty()) {
+			return;
+		}
+		// Shapes include the first vertex of the next cell, so cells ending on a region are included
 		int region_size = _terrain->get_region_size();
-		TypedArray<Vector2i> region_locs = _terrain->get_data()->get_region_locations();
-		for (int i = 0; i < region_locs.size(); i++) {
-			Vector2i region_loc = region_locs[i];
-			Vector2i shape_pos = region_loc * region_size;
-			Dictionary shape_data = _get_shape_data(shape_pos, region_size);
-			if (shape_data.is_empty()) {
-				LOG(ERROR, "Can't get shape data for ", region_loc);
-				continue;
+		for (const Vector2i &region_loc : changed) {
+			Vector2i start = region_loc * region_size;
+			Vector2i end = start + V2I(region_size);
+			for (const std::pair<const Vector3i, int> &cell : _cell_refs) {
+				const Vector3i &pos = cell.first;
+				int cell_size = _shape_size << pos.z;
+				if (pos.x < end.x && pos.y < end.y && pos.x + cell_size >= start.x && pos.y + cell_size >= start.y) {
+					_stale_cells.insert(pos);
+				}
 			}
-			Transform3D xform = shape_data["xform"];
-			xform.scale(Vector3(spacing, 1.f, spacing));
-			_shape_set_transform(i, xform);
-			_shape_set_disabled(i, false);
-			_shape_set_data(i, shape_data);
 		}
+		LOG(DEBUG, "Regions changed: ", changed.size(), ". Regenerating ", _stale_cells.size(), " collision cells");
+		_focus_changed = true;
+		return;
 	}
-	LOG(EXTREME, "Collision update time: ", Time::get_singleton()->get_ticks_usec() - time, " us");
+
+	std::set<Vector2i> affected; // Regions sharing merged boxes with removed ones
+	for (const Vector2i &region_loc : removed) {
+		_get_group_regions(region_loc, affected);
+	}
+	for (const Vector2i &region_loc : removed) {
+		_remove_region(region_loc);
+		affected.erase(region_loc);
+	}
+	for (const Vector2i &region_loc : affected) {
+		_queue_region(region_loc);
+	}
+	for (const Vector2i &region_loc : changed) {
+		LOG(DEBUG, "Queuing collision of region ", region_loc);
+		_queue_region(region_loc);
+	}
+	update();
+}
+
+// Regenerates only the shapes overlapping the global area, eg. after sculpting. Shapes include
+// the first vertex of the next cell, so edits on a cell border rebuild both sides.
+void Terrain3DCollision::invalidate_area(const AABB &p_area) {
+	if (!_initialized) {
+		return;
+	}
+	int time = Time::get_singleton()->get_ticks_usec();
+	// A batch in flight may have read the maps before the edit. Place it now, then rebuild over it.
+	_finish_jobs();
+	_apply_jobs(INT32_MAX);
+
+	real_t spacing = _terrain->get_vertex_spacing();
+	int shape_size = is_dynamic_mode() ? _shape_size : _get_full_shape_size();
+	Vector3 area_end = p_area.get_end();
+	Vector2i start = Vector2i(Math::floor(p_area.position.x / spacing), Math::floor(p_area.position.z / spacing));
+	Vector2i end = Vector2i(Math::ceil(area_end.x / spacing), Math::ceil(area_end.z / spacing));
+	for (const std::pair<const Vector3i, int> &cell : _cell_shapes) {
+		const Vector3i &pos = cell.first;
+		int cell_size = shape_size << pos.z;
+		if (pos.x > end.x || pos.y > end.y || pos.x + cell_size < start.x || pos.y + cell_size < start.y) {
+			continue;
+		}
+		// Merged flat shapes span other cells, so their regions are rebuilt together
+		if (_merged_cells.count(pos) > 0) {
+			Vector2i cell_pos = Vector2i(pos.x, pos.y);
+			Vector2i region_loc = V2I_DIVIDE_FLOOR(cell_pos, _terrain->get_region_size());
+			LOG(EXTREME, "Area overlaps merged shapes. Queuing region ", region_loc);
+			_queue_region(region_loc);
+			continue;
+		}
+		ShapeJob job;
+		if (_init_job(job, pos, shape_size)) {
+			_jobs.push_back(job);
+		}
+	}
+	LOG(EXTREME, "Invalidating ", _jobs.size(), " shapes in area: ", p_area);
+	_dispatch_jobs();
+	_finish_jobs();
+	_apply_jobs(INT32_MAX);
+	LOG(EXTREME, "Collision invalidate time: ", Time::get_singleton()->get_ticks_usec() - time, " us");
 }
 
 void Terrain3DCollision::destroy() {
 	_initialized = false;
-	_last_snapped_pos = V2I_MAX;
+	_finish_jobs();
+	_jobs.clear();
+	_jobs_applied = 0;
+	// Focus points remain, but their cells are counted again on the next update
+	for (std::pair<const int, FocusPoint> &it : _focus_points) {
+		it.second.cells.clear();
+		it.second.snapped_pos = V2I_MAX;
+	}
+	_cell_refs.clear();
+	_focus_changed = false;
+	_cell_shapes.clear();
+	_merged_cells.clear();
+	_merge_groups.clear();
+	_pending_regions.clear();
+	_built_regions.clear();
+	_stale_cells.clear();
+	_regions_built = 0;
+	_regions_total = 0;
+	_shape_cells.clear();
+	_free_shapes.clear();
+	_retired_shapes.clear();
 
 	// Physics Server
 	if (_static_body_rid.is_valid()) {
@@ -397,6 +1124,12 @@ void Terrain3DCollision::destroy() {
 			LOG(DEBUG, "Freeing CollisionShape RID ", i);
 			PS->free_rid(rid);
 		}
+		for (const RID &rid : _spare_shape_rids) {
+			if (rid.is_valid()) {
+				PS->free_rid(rid);
+			}
+		}
+		_spare_shape_rids.clear();
 
 		LOG(DEBUG, "Freeing StaticBody RID");
 		PS->free_rid(_static_body_rid);
@@ -458,6 +1191,88 @@ void Terrain3DCollision::set_radius(const uint16_t p_radius) {
 	}
 }
 
+void Terrain3DCollision::set_lods(const uint8_t p_lods) {
+	_lods = CLAMP(p_lods, 1, MAX_LODS);
+	LOG(INFO, "Setting collision dynamic lods: ", _lods);
+	if (is_dynamic_mode()) {
+		build();
+	}
+}
+
+void Terrain3DCollision::set_prediction_time(const real_t p_seconds) {
+	LOG(INFO, "Setting collision prediction time: ", p_seconds);
+	_prediction_time = CLAMP(p_seconds, 0.f, 10.f);
+}
+
+void Terrain3DCollision::set_camera_focus(const bool p_enabled) {
+	LOG(INFO, "Setting collision camera focus: ", p_enabled);
+	_camera_focus = p_enabled;
+	auto it = _focus_points.find(0);
+	if (!_camera_focus && it != _focus_points.end()) {
+		_release_cells(it->second);
+		_focus_points.erase(it);
+		_focus_changed = true;
+	}
+}
+
+// Adds a point to build dynamic collision around, such as a player on a server. A radius of 0 uses
+// the radius property. Returns an id for moving or removing it.
+int Terrain3DCollision::add_focus_point(const Vector3 &p_global_position, const uint16_t p_radius) {
+	int id = _next_focus_id++;
+	FocusPoint &focus = _focus_points[id];
+	focus.position = p_global_position;
+	focus.radius = (p_radius > 0) ? int_ceil_pow2(CLAMP(p_radius, 16, 256), 16) : 0;
+	LOG(INFO, "Adding collision focus point ", id, " at ", p_global_position, ", radius: ", focus.radius);
+	return id;
+}
+
+void Terrain3DCollision::set_focus_point_position(const int p_id, const Vector3 &p_global_position) {
+	auto it = _focus_points.find(p_id);
+	if (it == _focus_points.end()) {
+		LOG(ERROR, "Collision focus point not found: ", p_id);
+		return;
+	}
+	it->second.position = p_global_position;
+}
+
+// Sets the velocity used to build collision ahead of the focus point, replacing the estimate
+// from its movement
+void Terrain3DCollision::set_focus_point_velocity(const int p_id, const Vector3 &p_velocity) {
+	auto it = _focus_points.find(p_id);
+	if (it == _focus_points.end()) {
+		LOG(ERROR, "Collision focus point not found: ", p_id);
+		return;
+	}
+	it->second.velocity = p_velocity;
+	it->second.velocity_set = true;
+}
+
+void Terrain3DCollision::remove_focus_point(const int p_id) {
+	auto it = _focus_points.find(p_id);
+	if (it == _focus_points.end()) {
+		LOG(ERROR, "Collision focus point not found: ", p_id);
+		return;
+	}
+	LOG(INFO, "Removing collision focus point ", p_id);
+	_release_cells(it->second);
+	_focus_points.erase(it);
+	_focus_changed = true;
+}
+
+// Removes all added focus points, leaving the camera
+void Terrain3DCollision::clear_focus_points() {
+	LOG(INFO, "Clearing collision focus points");
+	for (auto it = _focus_points.begin(); it != _focus_points.end();) {
+		if (it->first == 0) {
+			++it;
+			continue;
+		}
+		_release_cells(it->second);
+		it = _focus_points.erase(it);
+		_focus_changed = true;
+	}
+}
+
 void Terrain3DCollision::set_layer(const uint32_t p_layers) {
 	LOG(INFO, "Setting collision layers: ", p_layers);
 	_layer = p_layers;
@@ -524,17 +1339,31 @@ void Terrain3DCollision::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("build"), &Terrain3DCollision::build);
 	ClassDB::bind_method(D_METHOD("update", "force"), &Terrain3DCollision::update, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("update_regions"), &Terrain3DCollision::update_regions);
+	ClassDB::bind_method(D_METHOD("invalidate_area", "area"), &Terrain3DCollision::invalidate_area);
 	ClassDB::bind_method(D_METHOD("destroy"), &Terrain3DCollision::destroy);
 	ClassDB::bind_method(D_METHOD("set_mode", "mode"), &Terrain3DCollision::set_mode);
 	ClassDB::bind_method(D_METHOD("get_mode"), &Terrain3DCollision::get_mode);
 	ClassDB::bind_method(D_METHOD("is_enabled"), &Terrain3DCollision::is_enabled);
 	ClassDB::bind_method(D_METHOD("is_editor_mode"), &Terrain3DCollision::is_editor_mode);
 	ClassDB::bind_method(D_METHOD("is_dynamic_mode"), &Terrain3DCollision::is_dynamic_mode);
+	ClassDB::bind_method(D_METHOD("is_generating"), &Terrain3DCollision::is_generating);
 
 	ClassDB::bind_method(D_METHOD("set_shape_size", "size"), &Terrain3DCollision::set_shape_size);
 	ClassDB::bind_method(D_METHOD("get_shape_size"), &Terrain3DCollision::get_shape_size);
 	ClassDB::bind_method(D_METHOD("set_radius", "radius"), &Terrain3DCollision::set_radius);
 	ClassDB::bind_method(D_METHOD("get_radius"), &Terrain3DCollision::get_radius);
+	ClassDB::bind_method(D_METHOD("set_lods", "lods"), &Terrain3DCollision::set_lods);
+	ClassDB::bind_method(D_METHOD("get_lods"), &Terrain3DCollision::get_lods);
+	ClassDB::bind_method(D_METHOD("set_prediction_time", "seconds"), &Terrain3DCollision::set_prediction_time);
+	ClassDB::bind_method(D_METHOD("get_prediction_time"), &Terrain3DCollision::get_prediction_time);
+	ClassDB::bind_method(D_METHOD("set_camera_focus", "enabled"), &Terrain3DCollision::set_camera_focus);
+	ClassDB::bind_method(D_METHOD("get_camera_focus"), &Terrain3DCollision::get_camera_focus);
+	ClassDB::bind_method(D_METHOD("add_focus_point", "global_position", "radius"), &Terrain3DCollision::add_focus_point, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("set_focus_point_position", "id", "global_position"), &Terrain3DCollision::set_focus_point_position);
+	ClassDB::bind_method(D_METHOD("set_focus_point_velocity", "id", "velocity"), &Terrain3DCollision::set_focus_point_velocity);
+	ClassDB::bind_method(D_METHOD("remove_focus_point", "id"), &Terrain3DCollision::remove_focus_point);
+	ClassDB::bind_method(D_METHOD("clear_focus_points"), &Terrain3DCollision::clear_focus_points);
 	ClassDB::bind_method(D_METHOD("set_layer", "layers"), &Terrain3DCollision::set_layer);
 	ClassDB::bind_method(D_METHOD("get_layer"), &Terrain3DCollision::get_layer);
 	ClassDB::bind_method(D_METHOD("set_mask", "mask"), &Terrain3DCollision::set_mask);
@@ -546,7 +1375,12 @@ void Terrain3DCollision::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "mode", PROPERTY_HINT_ENUM, "Disabled,Dynamic / Game,Dynamic / Editor,Full / Game,Full / Editor"), "set_mode", "get_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "shape_size", PROPERTY_HINT_RANGE, "8,64,8"), "set_shape_size", "get_shape_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "radius", PROPERTY_HINT_RANGE, "16,256,16"), "set_radius", "get_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lods", PROPERTY_HINT_RANGE, "1,8,1"), "set_lods", "get_lods");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "prediction_time", PROPERTY_HINT_RANGE, "0,10,.1,suffix:s"), "set_prediction_time", "get_prediction_time");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "camera_focus"), "set_camera_focus", "get_camera_focus");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_layer", "get_layer");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_mask", "get_mask");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "priority", PROPERTY_HINT_RANGE, "0.1,256,.1"), "set_priority", "get_priority");
+
+	ADD_SIGNAL(MethodInfo("build_progress", PropertyInfo(Variant::INT, "regions_built"), PropertyInfo(Variant::INT, "region_count")));
 }
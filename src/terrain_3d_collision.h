@@ -4,7 +4,11 @@
 #define TERRAIN3D_COLLISION_CLASS_H
 
 #include <godot_cpp/classes/collision_shape3d.hpp>
+#include <godot_cpp/classes/physics_server3d.hpp>
 #include <godot_cpp/classes/static_body3d.hpp>
+#include <deque>
+#include <map>
+#include <set>
 #include <vector>
 
 #include "constants.h"
@@ -27,6 +31,15 @@ public: // Constants
 		FULL_EDITOR,
 	};
 
+	static inline const int APPLY_LIMIT = 16; // Generated shapes swapped in per physics frame in dynamic mode
+	static inline const int MAX_LODS = 8;
+	static inline const real_t VELOCITY_SMOOTHING = .2f; // Weight of the newest estimate of focus point velocity
+	static inline const uint64_t VELOCITY_MAX_GAP = 500000; // Usecs between samples after which estimates restart
+	static inline const real_t MAX_LEAD_RADII = 4.f; // Farthest prediction, in outer ring radii
+	static inline const int FULL_SHAPE_SIZE = 256; // Largest shape in full mode; regions are split into these
+	static inline const int FULL_BATCH_REGIONS = 4; // Regions generated per batch in full mode
+	static inline const real_t FLAT_DEPTH = 1.f; // Thickness of the box replacing a flat shape
+
 private:
 	Terrain3D *_terrain = nullptr;
 
@@ -34,6 +47,9 @@ private:
 	CollisionMode _mode = DYNAMIC_GAME;
 	uint16_t _shape_size = 16;
 	uint16_t _radius = 64;
+	uint8_t _lods = 1;
+	real_t _prediction_time = 0.f;
+	bool _camera_focus = true;
 	uint32_t _layer = 1;
 	uint32_t _mask = 1;
 	real_t _priority = 1.f;
@@ -42,18 +58,110 @@ private:
 	RID _static_body_rid; // Physics Server Static Body
 	StaticBody3D *_static_body = nullptr; // Editor mode StaticBody3D
 	std::vector<CollisionShape3D *> _shapes; // All CollisionShape3Ds
+	std::vector<RID> _spare_shape_rids; // Shape id -> heightmap or box shape not in the body
 
 	bool _initialized = false;
-	Vector2i _last_snapped_pos = V2I_MAX;
+
+	// Dynamic collision covers the union of the grid cells around each focus point. Id 0 follows
+	// the camera if _camera_focus is set. Cells are reference counted by the focus points that
+	// cover them, so overlapping rings share shapes.
+	// Each ring out to _lods has cells twice the size of the ring within, sampling every 2^lod
+	// vertices, so all shapes have the same vertex count. Cells are keyed by the descaled top
+	// left corner in x, y and the lod in z.
+	struct FocusPoint {
+		Vector3 position = V3_ZERO; // Global
+		uint16_t radius = 0; // 0 uses _radius
+		Vector2i snapped_pos = V2I_MAX; // Descaled center of the cells below
+		Vector2i predicted_pos = V2I_MAX; // Descaled end of the path the cells extend along
+		std::vector<Vector3i> cells;
+		// Movement, given or estimated each physics frame
+		Vector3 velocity = V3_ZERO;
+		bool velocity_set = false;
+		Vector3 last_position = V3_ZERO;
+		uint64_t last_time = 0;
+	};
+	std::map<int, FocusPoint> _focus_points;
+	int _next_focus_id = 1;
+	bool _focus_changed = false;
+	std::map<Vector3i, int> _cell_refs; // Cell -> # focus points covering it
+
+	// Each shape holds the data of one cell. Shapes of cells that leave the area keep colliding
+	// until they are reused. More shapes are created when none are left. Flat cells get a box
+	// instead of a heightmap, and in full mode, adjacent ones at the same height share one box.
+	std::map<Vector3i, int> _cell_shapes; // Cell -> shape id, -1 if fully holed or merged
+	std::map<Vector3i, Vector3i> _merged_cells; // Cell sharing a box with its neighbors -> cell holding the box
+	std::map<Vector3i, Vector2i> _merge_groups; // Cell holding a shared box -> cells it covers in x, y
+	std::vector<Vector3i> _shape_cells; // Shape id -> cell, V3I_MAX if unused
+	std::vector<int> _free_shapes; // Unused shape ids
+	std::vector<int> _retired_shapes; // Shape ids of cells outside the area, farthest last
+
+	// Full mode builds regions in batches, over several frames. Both modes compare the regions built
+	// with the current ones to rebuild only those that changed.
+	std::deque<Vector2i> _pending_regions;
+	std::map<Vector2i, uint64_t> _built_regions; // Region location -> instance id of the region built
+	std::set<Vector3i> _stale_cells; // Dynamic mode cells to regenerate as their regions changed
+	int _regions_built = 0; // Progress of the pending regions, reset once all are built
+	int _regions_total = 0;
+
+	// Shape data is generated in batches on the WorkerThreadPool. Each job holds the map data it
+	// reads, so regions may change meanwhile. The main thread swaps finished shapes in, APPLY_LIMIT
+	// per frame, and only starts the next batch once all are in place.
+	struct ShapeJob {
+		Vector2i shape_pos = V2I_ZERO; // Descaled top left corner
+		int lod = 0;
+		int size = 0; // Vertices per side - 1
+		// Height and control map data of the regions the shape covers, row by row from region_loc.
+		// Shared copy on write with the maps, so edits made meanwhile don't reach the job.
+		Vector2i region_loc = V2I_ZERO;
+		Vector2i region_count = V2I_ZERO;
+		std::vector<PackedByteArray> heights;
+		std::vector<PackedByteArray> controls;
+		// Result
+		PackedFloat32Array map_data;
+		real_t min_height = FLT_MAX; // Greater than max_height if fully holed
+		real_t max_height = -FLT_MAX;
+		bool holes = false;
+		Vector2i merge_count = V2I(1); // Cells covered by the box of a flat shape
+		bool merged = false; // Covered by the box of another job
+		int unit = -1; // Index of the first job swapped in together with this one, -1 if none
+
+		bool is_flat() const { return min_height == max_height && !holes; }
+	};
+	std::vector<ShapeJob> _jobs;
+	int _jobs_applied = 0;
+	int64_t _job_group_id = -1;
+	uint64_t _job_start_time = 0;
 
 	Vector2i _snap_to_grid(const Vector2i &p_pos) const;
 	Vector2i _snap_to_grid(const Vector3 &p_pos) const;
-	Dictionary _get_shape_data(const Vector2i &p_position, const int p_size);
+	int _get_full_shape_size() const;
+	bool _init_job(ShapeJob &r_job, const Vector3i &p_cell, const int p_size);
+	void _extract_heights(ShapeJob &p_job) const;
+	Transform3D _get_shape_transform(const ShapeJob &p_job) const;
+	void _generate_shape_task(const uint32_t p_index);
+	void _merge_flat_jobs();
+	void _dispatch_jobs();
+	void _finish_jobs();
+	void _get_region_ids(std::map<Vector2i, uint64_t> &r_regions) const;
+	void _get_group_regions(const Vector2i &p_region_loc, std::set<Vector2i> &r_regions) const;
+	void _queue_region(const Vector2i &p_region_loc);
+	void _remove_region(const Vector2i &p_region_loc);
+	void _dispatch_regions();
+	bool _apply_jobs(const int p_limit);
+	int _add_shape();
+	int _take_shape();
+	void _release_shape(const int p_shape_id);
+	void _release_cells(FocusPoint &p_focus);
+	real_t _path_distance(const Vector2i &p_pos, const Vector2i &p_from, const Vector2i &p_to) const;
+	void _get_ring_cells(const Vector2i &p_from, const Vector2i &p_to, const int p_radius, std::vector<Vector3i> &r_cells) const;
+	void _add_ring_cell(const Vector3i &p_cell, const Vector2i &p_from, const Vector2i &p_to, const int p_radius, std::vector<Vector3i> &r_cells) const;
+	void _track_focus_points();
 
 	void _shape_set_disabled(const int p_shape_id, const bool p_disabled);
 	void _shape_set_transform(const int p_shape_id, const Transform3D &p_xform);
-	Vector3 _shape_get_position(const int p_shape_id) const;
+	RID _shape_swap_type(const int p_shape_id, const PhysicsServer3D::ShapeType p_type);
 	void _shape_set_data(const int p_shape_id, const Dictionary &p_dict);
+	void _shape_set_box(const int p_shape_id, const Vector3 &p_half_extents);
 
 public:
 	Terrain3DCollision() {}
@@ -62,6 +170,8 @@ public:
 
 	void build();
 	void update(const bool p_force = false);
+	void update_regions();
+	void invalidate_area(const AABB &p_area);
 	void destroy();
 
 	void set_mode(const CollisionMode p_mode);
@@ -69,11 +179,23 @@ public:
 	bool is_enabled() const { return _mode > DISABLED; }
 	bool is_editor_mode() const { return _mode == DYNAMIC_EDITOR || _mode == FULL_EDITOR; }
 	bool is_dynamic_mode() const { return _mode == DYNAMIC_GAME || _mode == DYNAMIC_EDITOR; }
+	bool is_generating() const { return _job_group_id >= 0 || _jobs_applied < _jobs.size() || !_pending_regions.empty(); }
 
 	void set_shape_size(const uint16_t p_size);
 	uint16_t get_shape_size() const { return _shape_size; }
 	void set_radius(const uint16_t p_radius);
 	uint16_t get_radius() const { return _radius; }
+	void set_lods(const uint8_t p_lods);
+	uint8_t get_lods() const { return _lods; }
+	void set_prediction_time(const real_t p_seconds);
+	real_t get_prediction_time() const { return _prediction_time; }
+	void set_camera_focus(const bool p_enabled);
+	bool get_camera_focus() const { return _camera_focus; }
+	int add_focus_point(const Vector3 &p_global_position, const uint16_t p_radius = 0);
+	void set_focus_point_position(const int p_id, const Vector3 &p_global_position);
+	void set_focus_point_velocity(const int p_id, const Vector3 &p_velocity);
+	void remove_focus_point(const int p_id);
+	void clear_focus_points();
 	void set_layer(const uint32_t p_layers);
 	uint32_t get_layer() const { return _layer; };
 	void set_mask(const uint32_t p_mask);
@@ -100,4 +222,13 @@ inline Vector2i Terrain3DCollision::_snap_to_grid(const Vector3 &p_pos) const {
 			_shape_size;
 }
 
+// Distance from the position to the nearest point on the path
+inline real_t Terrain3DCollision::_path_distance(const Vector2i &p_pos, const Vector2i &p_from, const Vector2i &p_to) const {
+	Vector2 path = Vector2(p_to - p_from);
+	Vector2 offset = Vector2(p_pos - p_from);
+	real_t length_sq = path.length_squared();
+	real_t t = (length_sq > 0.f) ? CLAMP(offset.dot(path) / length_sq, 0.f, 1.f) : 0.f;
+	return offset.distance_to(path * t);
+}
+
 #endif // TERRAIN3D_COLLISION_CLASS_H
\ No newline at end of file
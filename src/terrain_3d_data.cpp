@@ -6,6 +6,10 @@
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/resource_saver.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <algorithm>
+#include <cstring>
 
 #include "logger.h"
 #include "terrain_3d_data.h"
@@ -16,15 +20,856 @@
 
 void Terrain3DData::_clear() {
 	LOG(INFO, "Clearing data");
+	_finish_load(false);
+	_finish_save(false);
+	_finish_stream_requests();
+	_stream_files.clear();
+	_stream_dirty = true;
 	_region_map_dirty = true;
-	_region_map.clear();
 	_region_map.resize(REGION_MAP_SIZE * REGION_MAP_SIZE);
+	_region_map.fill(0);
 	_regions.clear();
+	_region_slots.fill(nullptr);
 	_region_locations.clear();
+	_layer_locations.clear();
+	_layer_regions.clear();
+	_free_layers.clear();
+	_layer_capacity = 0;
 	_master_height_range = V2_ZERO;
 	_generated_height_maps.clear();
 	_generated_control_maps.clear();
 	_generated_color_maps.clear();
+	_height_sampler.unref();
+}
+
+// Stores a region in _regions and the slot table, replacing any region at its location
+void Terrain3DData::_store_region(const Ref<Terrain3DRegion> &p_region) {
+	Vector2i region_loc = p_region->get_location();
+	_regions[region_loc] = p_region;
+	int map_index = get_region_map_index(region_loc);
+	if (map_index >= 0) {
+		_region_slots[map_index] = p_region.ptr();
+	}
+}
+
+// Rebuilds the slot table from _regions in case the dictionary was changed directly
+void Terrain3DData::_update_region_slots() {
+	_region_slots.fill(nullptr);
+	Array locs = _regions.keys();
+	for (int i = 0; i < locs.size(); i++) {
+		Ref<Terrain3DRegion> region = _regions[locs[i]];
+		int map_index = get_region_map_index(locs[i]);
+		if (region.is_valid() && map_index >= 0) {
+			_region_slots[map_index] = region.ptr();
+		}
+	}
+}
+
+// Validates a region loaded from p_path and prepares it to be added at p_region_loc
+Error Terrain3DData::_setup_loaded_region(const Ref<Terrain3DRegion> &p_region, const Vector2i &p_region_loc, const String &p_path) {
+	if (p_region.is_null()) {
+		LOG(ERROR, "Cannot load region at ", p_path);
+		return FAILED;
+	}
+	if (_regions.is_empty()) {
+		_terrain->set_region_size((Terrain3D::RegionSize)p_region->get_region_size());
+	} else if (_terrain->get_region_size() != (Terrain3D::RegionSize)p_region->get_region_size()) {
+		LOG(ERROR, "Region size mismatch. First loaded: ", _terrain->get_region_size(), " next: ",
+				p_region->get_region_size(), " in file: ", p_path);
+		return ERR_INVALID_DATA;
+	}
+	p_region->take_over_path(p_path);
+	p_region->set_location(p_region_loc);
+	p_region->set_version(CURRENT_VERSION); // Sends upgrade warning if old version
+	return OK;
+}
+
+// Fills r_files with the path of each region file in the directory, indexed by region location
+Error Terrain3DData::_list_region_files(const String &p_dir, Dictionary &r_files) const {
+	if (p_dir.is_empty()) {
+		LOG(ERROR, "Specified data directory is blank");
+		return ERR_INVALID_PARAMETER;
+	}
+	Ref<DirAccess> da = DirAccess::open(p_dir);
+	if (da.is_null()) {
+		LOG(ERROR, "Cannot read Terrain3D data directory: ", p_dir);
+		return ERR_CANT_OPEN;
+	}
+	PackedStringArray files = da->get_files();
+	for (int i = 0; i < files.size(); i++) {
+		String fname = files[i];
+		bool raw = fname.get_extension() == Terrain3DRegion::RAW_EXTENSION;
+		if (!fname.begins_with("terrain3d") || !(raw || fname.ends_with(".res"))) {
+			continue;
+		}
+		if (fname.contains(".tmp.")) {
+			LOG(WARN, "Ignoring incomplete file from an interrupted save: ", fname);
+			continue;
+		}
+		Vector2i loc = Util::filename_to_location(fname);
+		if (loc.x == INT32_MAX) {
+			LOG(ERROR, "Cannot get region location from file name: ", fname);
+			continue;
+		}
+		// Prefer raw files if a region has both
+		if (r_files.has(loc)) {
+			LOG(WARN, "Region ", loc, " has both .res and .", Terrain3DRegion::RAW_EXTENSION, " files. Using the .", Terrain3DRegion::RAW_EXTENSION, " file");
+			if (!raw) {
+				continue;
+			}
+		}
+		r_files[loc] = p_dir + String("/") + fname;
+	}
+	return OK;
+}
+
+/**
+ * Rebuilds the region map and _region_locations from _regions. Regions that are still active keep
+ * their layer in the texture arrays, so their map data stays on the GPU. Layers of removed regions
+ * go on the free list, and new regions take one from it, with their maps queued for upload. If the
+ * arrays have no free layers left, they are marked for a full rebuild with room to spare.
+ */
+void Terrain3DData::_update_region_layers() {
+	PackedInt32Array old_map = _region_map;
+	_region_map.resize(REGION_MAP_SIZE * REGION_MAP_SIZE);
+	_region_map.fill(0);
+	_region_map_dirty = false;
+	_region_locations = TypedArray<Vector2i>(); // enforce new pointer
+	_update_region_slots();
+
+	std::vector<bool> kept(_layer_locations.size(), false);
+	std::vector<Terrain3DRegion *> added;
+	Array locs = _regions.keys();
+	for (int i = 0; i < locs.size(); i++) {
+		Terrain3DRegion *region = get_region_ptr(locs[i]);
+		if (region == nullptr || region->is_deleted()) {
+			continue;
+		}
+		Vector2i region_loc = region->get_location();
+		int map_index = get_region_map_index(region_loc);
+		if (map_index < 0) {
+			continue;
+		}
+		_region_locations.push_back(region_loc);
+		int layer = (map_index < old_map.size()) ? old_map[map_index] - 1 : -1;
+		// A different region object at the same location, eg from undo, needs its maps uploaded
+		if (layer >= 0 && layer < int(_layer_locations.size()) &&
+				_layer_locations[layer] == region_loc && _layer_regions[layer] == region->get_instance_id()) {
+			kept[layer] = true;
+			_region_map[map_index] = layer + 1;
+		} else {
+			added.push_back(region);
+		}
+	}
+
+	// Free in descending order, so new regions take the lowest layers first
+	_free_layers.clear();
+	for (int layer = int(_layer_locations.size()) - 1; layer >= 0; layer--) {
+		if (!kept[layer]) {
+			_layer_locations[layer] = V2I_MAX;
+			_layer_regions[layer] = 0;
+			_free_layers.push_back(layer);
+		}
+	}
+	for (Terrain3DRegion *region : added) {
+		int layer;
+		if (!_free_layers.empty()) {
+			layer = _free_layers.back();
+			_free_layers.pop_back();
+		} else {
+			layer = _layer_locations.size();
+			_layer_locations.push_back(V2I_MAX);
+			_layer_regions.push_back(0);
+		}
+		_layer_locations[layer] = region->get_location();
+		_layer_regions[layer] = region->get_instance_id();
+		_region_map[get_region_map_index(region->get_location())] = layer + 1;
+		if (layer < _layer_capacity) {
+			LOG(DEBUG, "Placing region ", region->get_location(), " in free layer ", layer);
+			_generated_height_maps.queue_update(region->get_height_map(), layer);
+			_generated_control_maps.queue_update(region->get_control_map(), layer);
+			_generated_color_maps.queue_update(region->get_color_map(), layer);
+		}
+	}
+	if (int(_layer_locations.size()) > _layer_capacity) {
+		LOG(DEBUG, "Region texture arrays are full at ", _layer_capacity, " layers. Rebuilding");
+		_generated_height_maps.clear();
+		_generated_control_maps.clear();
+		_generated_color_maps.clear();
+	}
+}
+
+// Assigns layers to the active regions in order with no gaps, and sizes the arrays to fit them
+// plus Terrain3D::region_layer_reserve spare layers, or every region streaming could keep loaded.
+// Only valid when all arrays are rebuilt.
+void Terrain3DData::_compact_region_layers() {
+	int count = _region_locations.size();
+	_layer_locations.clear();
+	_layer_regions.clear();
+	_free_layers.clear();
+	for (int i = 0; i < count; i++) {
+		Vector2i region_loc = _region_locations[i];
+		_layer_locations.push_back(region_loc);
+		Terrain3DRegion *region = get_region_ptr(region_loc);
+		_layer_regions.push_back(region ? region->get_instance_id() : 0);
+		_region_map[get_region_map_index(region_loc)] = i + 1;
+	}
+	int reserve = _terrain->get_region_layer_reserve();
+	if (!_stream_files.is_empty()) {
+		int radius = int(Math::ceil(_terrain->get_streaming_unload_distance() / (_region_size * _vertex_spacing)));
+		reserve = MAX(reserve, (2 * radius + 1) * (2 * radius + 1) - count);
+	}
+	_layer_capacity = (count > 0 || !_stream_files.is_empty()) ? MIN(count + reserve, REGION_MAP_SIZE * REGION_MAP_SIZE) : 0;
+	_layer_locations.resize(_layer_capacity, V2I_MAX);
+	_layer_regions.resize(_layer_capacity, 0);
+	for (int layer = _layer_capacity - 1; layer >= count; layer--) {
+		_free_layers.push_back(layer);
+	}
+	LOG(EXTREME, "Region texture arrays sized for ", _layer_capacity, " layers, ", count, " used");
+}
+
+// Refreshes the arrays of active region maps, in _region_locations order
+bool Terrain3DData::_update_map_arrays() {
+	_height_maps.clear();
+	_control_maps.clear();
+	_color_maps.clear();
+	for (int i = 0; i < _region_locations.size(); i++) {
+		Vector2i region_loc = _region_locations[i];
+		Terrain3DRegion *region = get_region_ptr(region_loc);
+		if (region == nullptr) {
+			LOG(ERROR, "Can't find region ", region_loc, ", _regions: ", _regions,
+					", locations: ", _region_locations, ". Please report this error.");
+			return false;
+		}
+		_height_maps.push_back(region->get_height_map());
+		_control_maps.push_back(region->get_control_map());
+		_color_maps.push_back(region->get_color_map());
+	}
+	return true;
+}
+
+// Returns one image per texture array layer. Free layers share a blank image.
+TypedArray<Image> Terrain3DData::_get_layer_images(const MapType p_map_type) const {
+	TypedArray<Image> images;
+	Ref<Image> blank;
+	for (int layer = 0; layer < _layer_capacity; layer++) {
+		uint64_t region_id = (layer < int(_layer_regions.size())) ? _layer_regions[layer] : 0;
+		Terrain3DRegion *region = (region_id != 0) ? get_region_ptr(_layer_locations[layer]) : nullptr;
+		if (region != nullptr && region->get_instance_id() == region_id) {
+			images.push_back(region->get_map(p_map_type));
+			continue;
+		}
+		if (blank.is_null()) {
+			blank = Util::get_filled_image(_region_sizev, COLOR[p_map_type], p_map_type == TYPE_COLOR, FORMAT[p_map_type]);
+		}
+		images.push_back(blank);
+	}
+	return images;
+}
+
+// Uploads the layer areas queued by update_maps() this frame
+void Terrain3DData::_upload_maps() {
+	_map_upload_queued = false;
+	_generated_height_maps.upload_queued();
+	_generated_control_maps.upload_queued();
+	_generated_color_maps.upload_queued();
+}
+
+// Region files keep the format they were loaded from. New regions are saved as .res
+String Terrain3DData::_get_region_path(const Terrain3DRegion *p_region, const String &p_dir) const {
+	String extension = p_region->get_path().get_extension();
+	if (extension != Terrain3DRegion::RAW_EXTENSION) {
+		extension = "res";
+	}
+	return p_dir + String("/") + Util::location_to_filename(p_region->get_location(), extension);
+}
+
+// Writes one snapshot for save_directory(). Runs on WorkerThreadPool threads, so it only touches
+// its own entry in _saves.
+void Terrain3DData::_save_region_task(const uint32_t p_index) {
+	RegionSave &save = _saves[p_index];
+	save.error = save.snapshot->write_file(save.path, _save_16_bit);
+}
+
+// Waits for the files being written by save_directory(), then reports the results. Regions that
+// failed are marked modified again so the next save retries them.
+void Terrain3DData::_finish_save(const bool p_notify) {
+	if (_save_task_id < 0) {
+		return;
+	}
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(_save_task_id);
+	_save_task_id = -1;
+	int failed = 0;
+	for (const RegionSave &save : _saves) {
+		if (save.error == OK) {
+			LOG(INFO, "Saved region ", save.region->get_location(), " to ", save.path);
+			continue;
+		}
+		LOG(ERROR, "Could not save file: ", save.path, ", error: ", UtilityFunctions::error_string(save.error), " (", save.error, ")");
+		save.region->set_modified(true);
+		failed++;
+	}
+	int saved = _saves.size() - failed;
+	_saves.clear();
+	if (p_notify) {
+		emit_signal("save_finished", saved, failed);
+		_update_file_system();
+	}
+}
+
+// Rescans so the FileSystem panel shows saved and removed files
+void Terrain3DData::_update_file_system() const {
+	if (IS_EDITOR && !EditorInterface::get_singleton()->get_resource_filesystem()->is_scanning()) {
+		EditorInterface::get_singleton()->get_resource_filesystem()->scan();
+	}
+}
+
+// Prepares _import_file for import_height_file(). r16 files are headerless, so the size is given
+// or assumed square. Returns ERR_FILE_UNRECOGNIZED for files that can't be read in strips.
+Error Terrain3DData::_open_height_file(const String &p_file_name, const Vector2 &p_r16_height_range, const Vector2i &p_r16_size) {
+	_import_file = HeightFile();
+	_import_file.path = p_file_name;
+	String ext = p_file_name.get_extension().to_lower();
+	if (ext != "r16" && ext != "raw" && ext != "exr") {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	Ref<FileAccess> file = FileAccess::open(p_file_name, FileAccess::READ);
+	if (file.is_null()) {
+		LOG(ERROR, "Cannot open file: ", p_file_name, ", error: ", UtilityFunctions::error_string(FileAccess::get_open_error()));
+		return FileAccess::get_open_error();
+	}
+	if (ext == "exr") {
+		_import_file.exr = true;
+		return _read_exr_header(file);
+	}
+
+	_import_file.r16_range = p_r16_height_range;
+	_import_file.size = p_r16_size;
+	if (_import_file.size <= V2I_ZERO) {
+		uint64_t fsize = file->get_length();
+		int fwidth = sqrt(fsize / 2);
+		_import_file.size = Vector2i(fwidth, fwidth);
+		LOG(DEBUG, "Total file size is: ", fsize, " calculated width: ", fwidth, " dimensions: ", _import_file.size);
+	}
+	if (file->get_length() < uint64_t(_import_file.size.x) * _import_file.size.y * 2) {
+		LOG(ERROR, "File ", p_file_name, " is smaller than ", _import_file.size, " 16-bit pixels");
+		return ERR_FILE_CORRUPT;
+	}
+	return OK;
+}
+
+// Reads the header and scanline offset table of an OpenEXR file. Only single part scanline files
+// using NONE, RLE, ZIPS, or ZIP compression are supported.
+Error Terrain3DData::_read_exr_header(const Ref<FileAccess> &p_file) {
+	auto read_string = [&p_file]() {
+		PackedByteArray chars;
+		for (uint8_t c = p_file->get_8(); c != 0 && !p_file->eof_reached() && chars.size() < 256; c = p_file->get_8()) {
+			chars.push_back(c);
+		}
+		return chars.get_string_from_ascii();
+	};
+
+	if (p_file->get_32() != EXR_MAGIC) {
+		LOG(ERROR, "Not an OpenEXR file: ", _import_file.path);
+		return ERR_FILE_CORRUPT;
+	}
+	uint32_t version = p_file->get_32();
+	// Bit 9 tiled, 11 deep data, 12 multipart
+	if ((version & 0xFF) != 2 || (version & 0x1A00)) {
+		LOG(DEBUG, "Unsupported OpenEXR layout, version field: ", vformat("0x%x", version));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	struct Channel {
+		String name;
+		int type = 0;
+		bool subsampled = false;
+	};
+	std::vector<Channel> channels;
+	Rect2i data_window;
+	int compression = -1;
+	while (!p_file->eof_reached()) {
+		String name = read_string();
+		if (name.is_empty()) {
+			break;
+		}
+		read_string(); // Attribute type
+		uint32_t size = p_file->get_32();
+		uint64_t next = p_file->get_position() + size;
+		if (name == "channels") {
+			for (String channel = read_string(); !channel.is_empty(); channel = read_string()) {
+				Channel ch;
+				ch.name = channel;
+				ch.type = p_file->get_32();
+				p_file->get_32(); // pLinear and reserved
+				int x_sampling = p_file->get_32();
+				int y_sampling = p_file->get_32();
+				ch.subsampled = x_sampling != 1 || y_sampling != 1;
+				channels.push_back(ch);
+			}
+		} else if (name == "compression") {
+			compression = p_file->get_8();
+		} else if (name == "dataWindow") {
+			Vector2i min = Vector2i(int32_t(p_file->get_32()), int32_t(p_file->get_32()));
+			Vector2i max = Vector2i(int32_t(p_file->get_32()), int32_t(p_file->get_32()));
+			data_window = Rect2i(min, max - min + Vector2i(1, 1));
+		}
+		p_file->seek(next);
+	}
+	if (p_file->eof_reached() || channels.empty() || !data_window.has_area()) {
+		LOG(ERROR, "OpenEXR header is incomplete: ", _import_file.path);
+		return ERR_FILE_CORRUPT;
+	}
+
+	// Channels are stored per scanline in header order. Use luminance, red, or else the first.
+	const int type_bytes[] = { 4, 2, 4 };
+	int index = 0;
+	for (int i = 0; i < channels.size(); i++) {
+		if (channels[i].name == "Y") {
+			index = i;
+			break;
+		} else if (channels[i].name == "R") {
+			index = i;
+		}
+	}
+	_import_file.size = data_window.size;
+	int64_t pixel_bytes = 0;
+	for (int i = 0; i < channels.size(); i++) {
+		if (channels[i].type < 0 || channels[i].type > 2 || channels[i].subsampled) {
+			LOG(DEBUG, "Unsupported OpenEXR channel: ", channels[i].name);
+			return ERR_FILE_UNRECOGNIZED;
+		}
+		if (i == index) {
+			_import_file.channel_offset = pixel_bytes * _import_file.size.x;
+			_import_file.channel_type = channels[i].type;
+		}
+		pixel_bytes += type_bytes[channels[i].type];
+	}
+	_import_file.line_bytes = pixel_bytes * _import_file.size.x;
+
+	// 0 NONE, 1 RLE, 2 ZIPS, 3 ZIP
+	const int lines_per_chunk[] = { 1, 1, 1, 16 };
+	if (compression < 0 || compression > 3) {
+		LOG(DEBUG, "Unsupported OpenEXR compression: ", compression);
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	_import_file.compression = compression;
+	_import_file.lines_per_chunk = lines_per_chunk[compression];
+	int chunks = int_divide_ceil(_import_file.size.y, _import_file.lines_per_chunk);
+	_import_file.chunk_offsets.resize(chunks);
+	for (int i = 0; i < chunks; i++) {
+		_import_file.chunk_offsets[i] = p_file->get_64();
+	}
+	if (p_file->eof_reached()) {
+		LOG(ERROR, "OpenEXR offset table is incomplete: ", _import_file.path);
+		return ERR_FILE_CORRUPT;
+	}
+	LOG(DEBUG, "OpenEXR ", _import_file.size, " using channel ", channels[index].name, ", type: ",
+			_import_file.channel_type, ", compression: ", compression);
+	return OK;
+}
+
+// Expands one RLE or ZIP compressed OpenEXR chunk of p_size bytes, then reverses the byte
+// predictor and interleaving both apply before compression
+Error Terrain3DData::_decode_exr_chunk(const PackedByteArray &p_packed, const int64_t p_size, PackedByteArray &r_data) const {
+	PackedByteArray tmp;
+	if (_import_file.compression == 1) {
+		tmp.resize(p_size);
+		uint8_t *out = tmp.ptrw();
+		const int8_t *in = reinterpret_cast<const int8_t *>(p_packed.ptr());
+		int64_t in_size = p_packed.size();
+		int64_t i = 0;
+		int64_t o = 0;
+		while (i < in_size) {
+			int count = in[i++];
+			if (count < 0) {
+				count = -count;
+				if (i + count > in_size || o + count > p_size) {
+					return ERR_FILE_CORRUPT;
+				}
+				memcpy(out + o, in + i, count);
+				i += count;
+			} else {
+				count++;
+				if (i >= in_size || o + count > p_size) {
+					return ERR_FILE_CORRUPT;
+				}
+				memset(out + o, uint8_t(in[i++]), count);
+			}
+			o += count;
+		}
+		if (o != p_size) {
+			return ERR_FILE_CORRUPT;
+		}
+	} else {
+		tmp = p_packed.decompress(p_size, FileAccess::COMPRESSION_DEFLATE);
+		if (tmp.size() != p_size) {
+			return ERR_FILE_CORRUPT;
+		}
+	}
+
+	uint8_t *t = tmp.ptrw();
+	for (int64_t i = 1; i < p_size; i++) {
+		t[i] = uint8_t(int(t[i - 1]) + int(t[i]) - 128);
+	}
+	r_data.resize(p_size);
+	uint8_t *out = r_data.ptrw();
+	const uint8_t *t1 = t;
+	const uint8_t *t2 = t + (p_size + 1) / 2;
+	for (int64_t i = 0; i < p_size; i++) {
+		out[i] = (i & 1) ? *(t2++) : *(t1++);
+	}
+	return OK;
+}
+
+// Reads the heights of p_rect in the file into r_heights, with p_stride floats per row
+Error Terrain3DData::_read_height_rows(const Ref<FileAccess> &p_file, const Rect2i &p_rect, float *r_heights, const int p_stride) const {
+	const HeightFile &src = _import_file;
+	int width = p_rect.size.x;
+	if (!src.exr) {
+		real_t range = src.r16_range.y - src.r16_range.x;
+		for (int y = 0; y < p_rect.size.y; y++) {
+			p_file->seek((int64_t(p_rect.position.y + y) * src.size.x + p_rect.position.x) * 2);
+			PackedByteArray row = p_file->get_buffer(width * 2);
+			if (row.size() != width * 2) {
+				return ERR_FILE_EOF;
+			}
+			const uint16_t *values = reinterpret_cast<const uint16_t *>(row.ptr());
+			float *heights = r_heights + int64_t(y) * p_stride;
+			for (int x = 0; x < width; x++) {
+				heights[x] = real_t(values[x]) / 65535.f * range + src.r16_range.x;
+			}
+		}
+		return OK;
+	}
+
+	const int type_bytes[] = { 4, 2, 4 };
+	int pixel_bytes = type_bytes[src.channel_type];
+	int first_chunk = p_rect.position.y / src.lines_per_chunk;
+	int last_chunk = (p_rect.get_end().y - 1) / src.lines_per_chunk;
+	PackedByteArray lines;
+	for (int chunk = first_chunk; chunk <= last_chunk; chunk++) {
+		int first_line = chunk * src.lines_per_chunk;
+		int line_count = MIN(src.lines_per_chunk, src.size.y - first_line);
+		int64_t size = line_count * src.line_bytes;
+		p_file->seek(src.chunk_offsets[chunk]);
+		p_file->get_32(); // First scanline y
+		uint32_t packed_size = p_file->get_32();
+		if (packed_size > size) {
+			return ERR_FILE_CORRUPT;
+		}
+		PackedByteArray packed = p_file->get_buffer(packed_size);
+		if (packed.size() != packed_size) {
+			return ERR_FILE_EOF;
+		}
+		// Chunks that didn't compress are stored as is
+		if (src.compression == 0 || packed_size == size) {
+			lines = packed;
+		} else {
+			Error err = _decode_exr_chunk(packed, size, lines);
+			if (err != OK) {
+				return err;
+			}
+		}
+
+		int start = MAX(first_line, p_rect.position.y);
+		int end = MIN(first_line + line_count, p_rect.get_end().y);
+		for (int line = start; line < end; line++) {
+			const uint8_t *values = lines.ptr() + (line - first_line) * src.line_bytes + src.channel_offset + int64_t(p_rect.position.x) * pixel_bytes;
+			float *heights = r_heights + int64_t(line - p_rect.position.y) * p_stride;
+			switch (src.channel_type) {
+				case 0:
+					for (int x = 0; x < width; x++) {
+						heights[x] = float(reinterpret_cast<const uint32_t *>(values)[x]);
+					}
+					break;
+				case 1:
+					for (int x = 0; x < width; x++) {
+						heights[x] = half_to_float(reinterpret_cast<const uint16_t *>(values)[x]);
+					}
+					break;
+				default:
+					memcpy(heights, values, width * sizeof(float));
+					break;
+			}
+		}
+	}
+	return OK;
+}
+
+// Builds one region for import_height_file(). Runs on WorkerThreadPool threads, so it only
+// touches its own entry in _imports.
+void Terrain3DData::_import_height_task(const uint32_t p_index) {
+	HeightImport &region_import = _imports[p_index];
+	Ref<FileAccess> file = FileAccess::open(_import_file.path, FileAccess::READ);
+	if (file.is_null()) {
+		region_import.error = FileAccess::get_open_error();
+		return;
+	}
+	PackedByteArray data;
+	data.resize(int64_t(_region_size) * _region_size * sizeof(float));
+	data.fill(0);
+	float *heights = reinterpret_cast<float *>(data.ptrw());
+	region_import.error = _read_height_rows(file, region_import.rect, heights, _region_size);
+	if (region_import.error != OK) {
+		return;
+	}
+	// Apply scale and offset, filtering out invalid data, as import_images() does. Padding stays 0.
+	for (int y = 0; y < region_import.rect.size.y; y++) {
+		float *row = heights + y * _region_size;
+		for (int x = 0; x < region_import.rect.size.x; x++) {
+			row[x] = std::isnormal(row[x]) ? row[x] * _import_scale + _import_offset : _import_offset;
+		}
+	}
+
+	Ref<Terrain3DRegion> region;
+	region.instantiate();
+	region->set_location(region_import.region_loc);
+	TypedArray<Image> maps;
+	maps.resize(TYPE_MAX);
+	maps[TYPE_HEIGHT] = Image::create_from_data(_region_size, _region_size, false, FORMAT[TYPE_HEIGHT], data);
+	region->set_maps(maps);
+	region->update_height_pyramid();
+	region_import.region = region;
+}
+
+// Returns the region locations covered by layered_to_image() and export_image(), which always
+// include the origin region
+Rect2i Terrain3DData::_get_region_bounds() const {
+	Vector2i top_left = V2I_ZERO;
+	Vector2i bottom_right = V2I_ZERO;
+	for (int i = 0; i < _region_locations.size(); i++) {
+		Vector2i region_loc = _region_locations[i];
+		top_left = Vector2i(MIN(top_left.x, region_loc.x), MIN(top_left.y, region_loc.y));
+		bottom_right = Vector2i(MAX(bottom_right.x, region_loc.x), MAX(bottom_right.y, region_loc.y));
+	}
+	LOG(DEBUG, "Full range to cover all regions: ", top_left, " to ", bottom_right);
+	return Rect2i(top_left, bottom_right - top_left + Vector2i(1, 1));
+}
+
+// Writes a map of all regions to an r16 or uncompressed single channel OpenEXR file, one row of
+// regions at a time. Scanlines are built straight from the region maps and written in chunks of
+// EXPORT_BUFFER_SIZE, so memory use doesn't depend on the size of the world.
+Error Terrain3DData::_export_map_rows(const String &p_file_name, const MapType p_map_type, const bool p_exr) const {
+	Rect2i bounds = _get_region_bounds();
+	Vector2i img_size = bounds.size * _region_size;
+	int map_pixels = _region_size * _region_size;
+	// Regions without maps and empty areas are written as blank maps
+	PackedFloat32Array blank_row;
+	blank_row.resize(_region_size);
+	blank_row.fill(COLOR[p_map_type].r);
+
+	// r16 is scaled to the range of all values, including empty areas
+	float height_min = 0.f;
+	float scale = 0.f;
+	if (!p_exr) {
+		Vector2 min_max = Vector2(FLT_MAX, -FLT_MAX);
+		if (get_region_count() < bounds.get_area()) {
+			min_max = Vector2(blank_row[0], blank_row[0]);
+		}
+		for (int i = 0; i < _region_locations.size(); i++) {
+			const Image *map = get_region_ptr(_region_locations[i])->get_map_ptr(p_map_type);
+			PackedByteArray data = map->get_data();
+			const float *values = reinterpret_cast<const float *>(data.ptr());
+			int count = MIN(int64_t(map_pixels), data.size() / int64_t(sizeof(float)));
+			for (int j = 0; j < count; j++) {
+				min_max.x = MIN(min_max.x, values[j]);
+				min_max.y = MAX(min_max.y, values[j]);
+			}
+		}
+		LOG(MESG, "Minimum height: ", min_max.x, ", Maximum height: ", min_max.y);
+		height_min = min_max.x;
+		scale = (min_max.y > min_max.x) ? 65535.f / (min_max.y - min_max.x) : 0.f;
+	}
+
+	Ref<FileAccess> file = FileAccess::open(p_file_name, FileAccess::WRITE);
+	if (file.is_null()) {
+		LOG(ERROR, "Cannot open file '" + p_file_name + "' for writing");
+		return FileAccess::get_open_error();
+	}
+	int64_t pixel_bytes = p_exr ? sizeof(float) : sizeof(uint16_t);
+	int64_t line_bytes = pixel_bytes * img_size.x;
+	if (p_exr) {
+		auto store_attribute = [&file](const String &p_name, const String &p_type, const int p_size) {
+			file->store_buffer(p_name.to_ascii_buffer());
+			file->store_8(0);
+			file->store_buffer(p_type.to_ascii_buffer());
+			file->store_8(0);
+			file->store_32(p_size);
+		};
+		file->store_32(EXR_MAGIC);
+		file->store_32(2); // Version 2, single part scanline
+		store_attribute("channels", "chlist", 19);
+		file->store_buffer(String("Y").to_ascii_buffer());
+		file->store_8(0);
+		file->store_32(2); // FLOAT
+		file->store_32(0); // pLinear and reserved
+		file->store_32(1); // x, y sampling
+		file->store_32(1);
+		file->store_8(0);
+		store_attribute("compression", "compression", 1);
+		file->store_8(0); // NONE
+		for (const char *window : { "dataWindow", "displayWindow" }) {
+			store_attribute(window, "box2i", 16);
+			file->store_32(0);
+			file->store_32(0);
+			file->store_32(img_size.x - 1);
+			file->store_32(img_size.y - 1);
+		}
+		store_attribute("lineOrder", "lineOrder", 1);
+		file->store_8(0); // INCREASING_Y
+		store_attribute("pixelAspectRatio", "float", 4);
+		file->store_float(1.f);
+		store_attribute("screenWindowCenter", "v2f", 8);
+		file->store_float(0.f);
+		file->store_float(0.f);
+		store_attribute("screenWindowWidth", "float", 4);
+		file->store_float(1.f);
+		file->store_8(0); // End of header
+		// Each scanline is one chunk, prefixed by its y and size
+		uint64_t chunk_offset = file->get_position() + uint64_t(img_size.y) * sizeof(uint64_t);
+		for (int y = 0; y < img_size.y; y++) {
+			file->store_64(chunk_offset);
+			chunk_offset += 8 + line_bytes;
+		}
+		line_bytes += 8;
+	}
+
+	int lines_per_buffer = MAX(1, int(EXPORT_BUFFER_SIZE / line_bytes));
+	PackedByteArray buffer;
+	buffer.resize(lines_per_buffer * line_bytes);
+	int buffered = 0;
+	std::vector<PackedByteArray> maps(bounds.size.x); // Holds the map data of the current row of regions
+	for (int ry = 0; ry < bounds.size.y; ry++) {
+		for (int rx = 0; rx < bounds.size.x; rx++) {
+			Vector2i region_loc = bounds.position + Vector2i(rx, ry);
+			maps[rx] = PackedByteArray();
+			if (get_region_id(region_loc) >= 0) {
+				maps[rx] = get_region_ptr(region_loc)->get_map_ptr(p_map_type)->get_data();
+			}
+			if (maps[rx].size() < map_pixels * int64_t(sizeof(float))) {
+				maps[rx] = PackedByteArray();
+			}
+		}
+		for (int y = 0; y < _region_size; y++) {
+			uint8_t *line = buffer.ptrw() + buffered * line_bytes;
+			if (p_exr) {
+				int32_t header[2] = { ry * _region_size + y, int32_t(line_bytes - 8) };
+				memcpy(line, header, 8);
+				line += 8;
+			}
+			for (int rx = 0; rx < bounds.size.x; rx++) {
+				const float *src = maps[rx].is_empty() ? blank_row.ptr() :
+														reinterpret_cast<const float *>(maps[rx].ptr()) + y * _region_size;
+				if (p_exr) {
+					memcpy(line + rx * _region_size * sizeof(float), src, _region_size * sizeof(float));
+				} else {
+					_remap_to_16_bit(src, reinterpret_cast<uint16_t *>(line) + rx * _region_size, _region_size, height_min, scale);
+				}
+			}
+			if (++buffered == lines_per_buffer) {
+				file->store_buffer(buffer);
+				buffered = 0;
+			}
+		}
+	}
+	if (buffered > 0) {
+		file->store_buffer(buffer.slice(0, buffered * line_bytes));
+	}
+	LOG(MESG, "Wrote ", img_size, " sized ", TYPESTR[p_map_type], " map to: ", p_file_name);
+	return file->get_error();
+}
+
+// Scales floats to the 0-65535 range. Branch free so the compiler can vectorize it.
+// NaN becomes 0.
+void Terrain3DData::_remap_to_16_bit(const float *p_src, uint16_t *r_dst, const int p_count, const float p_min, const float p_scale) {
+	for (int i = 0; i < p_count; i++) {
+		float value = (p_src[i] - p_min) * p_scale;
+		r_dst[i] = uint16_t(std::min(65535.f, std::max(0.f, value)));
+	}
+}
+
+// Lists the region files in the directory for update_streaming() without loading any
+void Terrain3DData::_scan_directory(const String &p_dir) {
+	Dictionary files;
+	if (_list_region_files(p_dir, files) != OK) {
+		return;
+	}
+	_clear();
+	_stream_files = files;
+	_stream_dirty = true;
+	LOG(INFO, "Found ", _stream_files.size(), " region files to stream from ", p_dir);
+	force_update_maps();
+}
+
+// Decodes one file for load_directory(). Runs on WorkerThreadPool threads, so it only touches
+// its own entry in _loads.
+void Terrain3DData::_load_region_task(const uint32_t p_index) {
+	RegionLoad &load = _loads[p_index];
+	LOG(DEBUG, "Loading region from ", load.path);
+	Ref<Terrain3DRegion> region = ResourceLoader::get_singleton()->load(load.path, "Terrain3DRegion", ResourceLoader::CACHE_MODE_IGNORE);
+	if (region.is_valid()) {
+		// Leaves add_region() nothing to convert or rebuild on the main thread
+		region->sanitize_maps();
+		region->update_height_pyramid();
+	}
+	load.region = region;
+	_loads_finished.fetch_add(1, std::memory_order_release);
+}
+
+// Waits for the files being decoded by load_directory_async(), then adds the regions and builds
+// the maps once. Unless p_keep, the loaded regions are discarded.
+void Terrain3DData::_finish_load(const bool p_keep) {
+	if (_load_task_id < 0) {
+		return;
+	}
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(_load_task_id);
+	_load_task_id = -1;
+	if (!p_keep) {
+		_loads.clear();
+		return;
+	}
+	// Add in file order, so the first region still sets the region size
+	int count = _loads.size();
+	for (const RegionLoad &load : _loads) {
+		if (_setup_loaded_region(load.region, load.location, load.path) != OK) {
+			continue;
+		}
+		LOG(INFO, "Loaded region: ", load.location, " size: ", load.region->get_region_size());
+		add_region(load.region, false);
+	}
+	_loads.clear();
+	_loads_reported = count;
+	emit_signal("load_progress", count, count);
+	force_update_maps();
+	LOG(INFO, "Loaded ", count, " regions in ", (Time::get_singleton()->get_ticks_usec() - _load_start_time) / 1000, "ms");
+}
+
+// Waits for and discards any regions still loading, so the loader doesn't hold them
+void Terrain3DData::_finish_stream_requests() {
+	Array paths = _stream_requests.values();
+	for (int i = 0; i < paths.size(); i++) {
+		LOG(DEBUG, "Discarding streamed region ", paths[i]);
+		ResourceLoader::get_singleton()->load_threaded_get(paths[i]);
+	}
+	_stream_requests.clear();
+}
+
+// Releases a streamed region without marking it for deletion, so its file is kept
+void Terrain3DData::_unload_region(const Vector2i &p_region_loc) {
+	Terrain3DRegion *region = get_region_ptr(p_region_loc);
+	if (region == nullptr) {
+		return;
+	}
+	LOG(INFO, "Unloading region ", p_region_loc);
+	Array mesh_ids = region->get_instances().keys();
+	for (int i = 0; i < mesh_ids.size(); i++) {
+		_terrain->get_instancer()->_destroy_mmi_by_location(p_region_loc, mesh_ids[i]);
+	}
+	_region_locations.erase(p_region_loc);
+	_region_slots[get_region_map_index(p_region_loc)] = nullptr;
+	_regions.erase(p_region_loc); // Frees the region unless referenced elsewhere
+	_region_map_dirty = true;
 }
 
 // Structured to work with do_for_regions. Should be renamed when copy_paste is expanded
@@ -55,11 +900,17 @@ void Terrain3DData::initialize(Terrain3D *p_terrain) {
 	_terrain = p_terrain;
 	_region_map.resize(REGION_MAP_SIZE * REGION_MAP_SIZE);
 	_vertex_spacing = _terrain->get_vertex_spacing();
-	if (!prev_initialized && !_terrain->get_data_directory().is_empty()) {
-		load_directory(_terrain->get_data_directory());
-	}
 	_region_size = _terrain->get_region_size();
 	_region_sizev = Vector2i(_region_size, _region_size);
+	_height_sampler.unref();
+	if (!prev_initialized && !_terrain->get_data_directory().is_empty()) {
+		// The editor always loads everything, so regions that aren't loaded can't be overwritten
+		if (_terrain->get_streaming_enabled() && !IS_EDITOR) {
+			_scan_directory(_terrain->get_data_directory());
+		} else {
+			load_directory(_terrain->get_data_directory());
+		}
+	}
 }
 
 void Terrain3DData::set_region_locations(const TypedArray<Vector2i> &p_locations) {
@@ -69,6 +920,15 @@ void Terrain3DData::set_region_locations(const TypedArray<Vector2i> &p_locations
 	update_maps();
 }
 
+// Region locations indexed by texture array layer, for the shader. Free layers hold V2I_MAX.
+TypedArray<Vector2i> Terrain3DData::get_layer_locations() const {
+	TypedArray<Vector2i> locations;
+	for (const Vector2i &region_loc : _layer_locations) {
+		locations.push_back(region_loc);
+	}
+	return locations;
+}
+
 // Returns an array of active regions, optionally a shallow or deep copy
 TypedArray<Terrain3DRegion> Terrain3DData::get_regions_active(const bool p_copy, const bool p_deep) const {
 	TypedArray<Terrain3DRegion> region_arr;
@@ -93,8 +953,8 @@ void Terrain3DData::do_for_regions(const Rect2i &p_area, const Callable &p_callb
 		current_region_loc.y = y;
 		for (int x = location_bounds.position.x; x < location_bounds.get_end().x; x++) {
 			current_region_loc.x = x;
-			Ref<Terrain3DRegion> region = get_region(current_region_loc);
-			if (region.is_valid() && !region->is_deleted()) {
+			Terrain3DRegion *region = get_region_ptr(current_region_loc);
+			if (region && !region->is_deleted()) {
 				LOG(DEBUG, "Current region: ", current_region_loc);
 				Rect2i region_area = p_area.intersection(Rect2i(current_region_loc * _region_size, _region_sizev));
 				LOG(DEBUG, "Region bounds: ", Rect2i(current_region_loc * _region_size, _region_sizev));
@@ -103,7 +963,7 @@ void Terrain3DData::do_for_regions(const Rect2i &p_area, const Callable &p_callb
 				Rect2i src_coords(region_area.position - (region->get_location() * _region_sizev), dst_coords.size);
 				LOG(DEBUG, "src map coords: ", src_coords);
 				LOG(DEBUG, "dst map coords: ", dst_coords);
-				p_callback.call(region.ptr(), src_coords, dst_coords);
+				p_callback.call(region, src_coords, dst_coords);
 			}
 		}
 	}
@@ -123,8 +983,8 @@ void Terrain3DData::change_region_size(int p_new_size) {
 	Dictionary new_region_points;
 	Array locs = _regions.keys();
 	for (int i = 0; i < locs.size(); i++) {
-		Ref<Terrain3DRegion> region = get_region(locs[i]);
-		if (region.is_valid() && !region->is_deleted()) {
+		Terrain3DRegion *region = get_region_ptr(locs[i]);
+		if (region && !region->is_deleted()) {
 			Point2i region_position = region->get_location() * _region_size;
 			Rect2i location_bounds(V2I_DIVIDE_FLOOR(region_position, p_new_size), V2I_DIVIDE_CEIL(_region_sizev, p_new_size));
 			for (int y = location_bounds.position.y; y < location_bounds.get_end().y; y++) {
@@ -177,8 +1037,8 @@ void Terrain3DData::change_region_size(int p_new_size) {
 }
 
 void Terrain3DData::set_region_modified(const Vector2i &p_region_loc, const bool p_modified) {
-	Ref<Terrain3DRegion> region = get_region(p_region_loc);
-	if (region.is_null()) {
+	Terrain3DRegion *region = get_region_ptr(p_region_loc);
+	if (region == nullptr) {
 		LOG(ERROR, "Region not found at: ", p_region_loc);
 		return;
 	}
@@ -186,8 +1046,8 @@ void Terrain3DData::set_region_modified(const Vector2i &p_region_loc, const bool
 }
 
 bool Terrain3DData::is_region_modified(const Vector2i &p_region_loc) const {
-	Ref<Terrain3DRegion> region = get_region(p_region_loc);
-	if (region.is_null()) {
+	Terrain3DRegion *region = get_region_ptr(p_region_loc);
+	if (region == nullptr) {
 		LOG(ERROR, "Region not found at: ", p_region_loc);
 		return false;
 	}
@@ -195,8 +1055,8 @@ bool Terrain3DData::is_region_modified(const Vector2i &p_region_loc) const {
 }
 
 void Terrain3DData::set_region_deleted(const Vector2i &p_region_loc, const bool p_deleted) {
-	Ref<Terrain3DRegion> region = get_region(p_region_loc);
-	if (region.is_null()) {
+	Terrain3DRegion *region = get_region_ptr(p_region_loc);
+	if (region == nullptr) {
 		LOG(ERROR, "Region not found at: ", p_region_loc);
 		return;
 	}
@@ -204,8 +1064,8 @@ void Terrain3DData::set_region_deleted(const Vector2i &p_region_loc, const bool
 }
 
 bool Terrain3DData::is_region_deleted(const Vector2i &p_region_loc) const {
-	Ref<Terrain3DRegion> region = get_region(p_region_loc);
-	if (region.is_null()) {
+	Terrain3DRegion *region = get_region_ptr(p_region_loc);
+	if (region == nullptr) {
 		LOG(ERROR, "Region not found at: ", p_region_loc);
 		return true;
 	}
@@ -254,11 +1114,11 @@ Error Terrain3DData::add_region(const Ref<Terrain3DRegion> &p_region, const bool
 	} else {
 		LOG(INFO, "Overwriting ", (_regions.has(region_loc)) ? "deleted" : "existing", " region at ", region_loc);
 	}
-	_regions[region_loc] = p_region;
+	_store_region(p_region);
 	_region_map_dirty = true;
 	LOG(DEBUG, "Storing region ", region_loc, " version ", vformat("%.3f", p_region->get_version()), " id: ", _region_locations.size());
 	if (p_update) {
-		force_update_maps();
+		update_maps();
 		_terrain->get_instancer()->force_update_mmis();
 	}
 	return OK;
@@ -289,25 +1149,65 @@ void Terrain3DData::remove_region(const Ref<Terrain3DRegion> &p_region, const bo
 		LOG(ERROR, "Region ", region_loc, " not found in region_locations. Returning");
 		return;
 	}
+	// The region stays in _regions and its slot until saved, so only the active arrays change
 	p_region->set_deleted(true);
 	_region_locations.remove_at(region_id);
 	_region_map_dirty = true;
 	LOG(DEBUG, "Removing from region_locations, new size: ", _region_locations.size());
 	if (p_update) {
 		LOG(DEBUG, "Updating generated maps");
-		force_update_maps();
+		update_maps();
 		_terrain->get_instancer()->force_update_mmis();
 	}
 }
 
+/**
+ * Saves all modified regions to the directory and removes the files of deleted regions. Each
+ * modified region is snapshotted, then the snapshots are encoded and written in parallel on the
+ * WorkerThreadPool. If Terrain3D.save_in_background is enabled, this returns right away and
+ * editing can continue; update_saving() emits save_finished once all files are written.
+ */
 void Terrain3DData::save_directory(const String &p_dir) {
 	LOG(INFO, "Saving data files to ", p_dir);
+	_finish_save();
+	_save_16_bit = _terrain->get_save_16_bit();
 	Array locations = _regions.keys();
 	for (int i = 0; i < locations.size(); i++) {
-		save_region(locations[i], p_dir, _terrain->get_save_16_bit());
+		Ref<Terrain3DRegion> region = _regions[locations[i]];
+		if (region->is_deleted()) {
+			save_region(locations[i], p_dir, _save_16_bit);
+			continue;
+		}
+		if (!region->is_modified()) {
+			LOG(DEBUG, "Region ", locations[i], " not modified. Skipping");
+			continue;
+		}
+		RegionSave save;
+		save.path = _get_region_path(region.ptr(), p_dir);
+		save.region = region;
+		region->take_over_path(save.path);
+		region->set_version(CURRENT_VERSION);
+		save.snapshot = region->get_snapshot();
+		// Edits made while writing mark it modified again
+		region->set_modified(false);
+		_saves.push_back(save);
+	}
+	if (_saves.empty()) {
+		_update_file_system();
+		return;
 	}
-	if (IS_EDITOR && !EditorInterface::get_singleton()->get_resource_filesystem()->is_scanning()) {
-		EditorInterface::get_singleton()->get_resource_filesystem()->scan();
+	LOG(MESG, "Writing ", _saves.size(), (_save_16_bit) ? " 16-bit" : "", " regions to ", p_dir);
+	_save_task_id = WorkerThreadPool::get_singleton()->add_group_task(callable_mp(this, &Terrain3DData::_save_region_task), _saves.size(), -1, true, "Terrain3D save regions");
+	if (!_terrain->get_save_in_background()) {
+		_finish_save();
+	}
+}
+
+// Finishes a save started by save_directory() once all files are written. Called each physics
+// frame by Terrain3D.
+void Terrain3DData::update_saving() {
+	if (_save_task_id >= 0 && WorkerThreadPool::get_singleton()->is_group_task_completed(_save_task_id)) {
+		_finish_save();
 	}
 }
 
@@ -318,12 +1218,14 @@ void Terrain3DData::save_region(const Vector2i &p_region_loc, const String &p_di
 		LOG(ERROR, "No region found at: ", p_region_loc);
 		return;
 	}
-	String fname = Util::location_to_filename(p_region_loc);
-	String path = p_dir + String("/") + fname;
+	_finish_save();
+	String path = _get_region_path(region.ptr(), p_dir);
+	String fname = path.get_file();
 	// If region marked for deletion, remove from disk and from _regions, but don't free in case stored in undo
 	if (region->is_deleted()) {
 		LOG(DEBUG, "Removing ", p_region_loc, " from _regions");
 		_regions.erase(p_region_loc);
+		_region_slots[get_region_map_index(p_region_loc)] = nullptr;
 		LOG(DEBUG, "File to be deleted: ", path);
 		if (!FileAccess::file_exists(path)) {
 			LOG(INFO, "File to delete ", path, " doesn't exist. (Maybe from add, undo, save)");
@@ -347,81 +1249,229 @@ void Terrain3DData::save_region(const Vector2i &p_region_loc, const String &p_di
 	}
 }
 
+/**
+ * Loads all region files in the directory, decoding them in parallel on the WorkerThreadPool, and
+ * returns once all are added. Emits load_progress when starting and when done. Region sizes are
+ * checked once all are loaded, and regions that don't match the first are skipped.
+ */
 void Terrain3DData::load_directory(const String &p_dir) {
-	if (p_dir.is_empty()) {
-		LOG(ERROR, "Specified data directory is blank");
+	load_directory_async(p_dir);
+	_finish_load();
+}
+
+/**
+ * Clears the data and starts decoding all region files in the directory on the WorkerThreadPool,
+ * returning right away. update_loading() emits load_progress as files finish, and adds the
+ * regions and builds the maps once all are decoded.
+ */
+void Terrain3DData::load_directory_async(const String &p_dir) {
+	Dictionary files;
+	if (_list_region_files(p_dir, files) != OK) {
 		return;
 	}
-	Ref<DirAccess> da = DirAccess::open(p_dir);
-	if (da.is_null()) {
-		LOG(ERROR, "Cannot read Terrain3D data directory: ", p_dir);
+	_clear();
+
+	Array locations = files.keys();
+	int count = locations.size();
+	LOG(INFO, "Loading ", count, " region files from ", p_dir);
+	_load_start_time = Time::get_singleton()->get_ticks_usec();
+	_loads.resize(count);
+	for (int i = 0; i < count; i++) {
+		_loads[i].location = locations[i];
+		_loads[i].path = files[locations[i]];
+	}
+	_loads_finished = 0;
+	_loads_reported = 0;
+	emit_signal("load_progress", 0, count);
+	if (count == 0) {
+		force_update_maps();
 		return;
 	}
-	_clear();
+	_load_task_id = WorkerThreadPool::get_singleton()->add_group_task(callable_mp(this, &Terrain3DData::_load_region_task),
+			count, -1, true, "Terrain3D load regions");
+}
 
-	LOG(INFO, "Loading region files from ", p_dir);
-	PackedStringArray files = da->get_files();
-	for (int i = 0; i < files.size(); i++) {
-		String fname = files[i];
-		String path = p_dir + String("/") + fname;
-		if (!fname.begins_with("terrain3d") || !fname.ends_with(".res")) {
-			continue;
-		}
-		LOG(DEBUG, "Loading region from ", path);
-		Vector2i loc = Util::filename_to_location(fname);
-		if (loc.x == INT32_MAX) {
-			LOG(ERROR, "Cannot get region location from file name: ", fname);
-			continue;
-		}
-		Ref<Terrain3DRegion> region = ResourceLoader::get_singleton()->load(path, "Terrain3DRegion", ResourceLoader::CACHE_MODE_IGNORE);
-		if (region.is_null()) {
-			LOG(ERROR, "Cannot load region at ", path);
-			continue;
-		}
-		LOG(INFO, "Loaded region: ", loc, " size: ", region->get_region_size());
-		if (_regions.is_empty()) {
-			_terrain->set_region_size((Terrain3D::RegionSize)region->get_region_size());
-		} else {
-			if (_terrain->get_region_size() != (Terrain3D::RegionSize)region->get_region_size()) {
-				LOG(ERROR, "Region size mismatch. First loaded: ", _terrain->get_region_size(), " next: ",
-						region->get_region_size(), " in file: ", path);
-				return;
-			}
-		}
-		region->take_over_path(path);
-		region->set_location(loc);
-		region->set_version(CURRENT_VERSION); // Sends upgrade warning if old version
-		add_region(region, false);
+// Reports the files decoded since the last call, and finishes a load started by
+// load_directory_async() once all are decoded. Called each physics frame by Terrain3D.
+void Terrain3DData::update_loading() {
+	if (_load_task_id < 0) {
+		return;
+	}
+	if (WorkerThreadPool::get_singleton()->is_group_task_completed(_load_task_id)) {
+		_finish_load();
+		return;
+	}
+	int finished = _loads_finished.load(std::memory_order_acquire);
+	if (finished > _loads_reported) {
+		_loads_reported = finished;
+		emit_signal("load_progress", finished, int(_loads.size()));
 	}
-	force_update_maps();
 }
 
 //TODO have load_directory call load_region, or make a load_file that loads a specific path
 void Terrain3DData::load_region(const Vector2i &p_region_loc, const String &p_dir, const bool p_update) {
 	LOG(INFO, "Loading region from location ", p_region_loc);
 	String path = p_dir + String("/") + Util::location_to_filename(p_region_loc);
-	if (!FileAccess::file_exists(path)) {
+	String raw_path = p_dir + String("/") + Util::location_to_filename(p_region_loc, Terrain3DRegion::RAW_EXTENSION);
+	if (FileAccess::file_exists(raw_path)) {
+		path = raw_path;
+	} else if (!FileAccess::file_exists(path)) {
 		LOG(ERROR, "File ", path, " doesn't exist");
 		return;
 	}
 	Ref<Terrain3DRegion> region = ResourceLoader::get_singleton()->load(path, "Terrain3DRegion", ResourceLoader::CACHE_MODE_IGNORE);
-	if (region.is_null()) {
-		LOG(ERROR, "Cannot load region at ", path);
+	if (_setup_loaded_region(region, p_region_loc, path) != OK) {
 		return;
 	}
-	if (_regions.is_empty()) {
-		_terrain->set_region_size((Terrain3D::RegionSize)region->get_region_size());
-	} else {
-		if (_terrain->get_region_size() != (Terrain3D::RegionSize)region->get_region_size()) {
-			LOG(ERROR, "Region size mismatch. First loaded: ", _terrain->get_region_size(), " next: ",
-					region->get_region_size(), " in file: ", path);
-			return;
+	add_region(region, p_update);
+}
+
+/**
+ * Streams regions in and out around the focus points, set by set_streaming_focus_points(), or
+ * the camera position if none are set. Files within Terrain3D.streaming_load_distance are loaded
+ * on worker threads, nearest first. Streamed regions beyond streaming_unload_distance, or beyond
+ * streaming_memory_budget, are unloaded unless they have unsaved changes. All regions that arrive
+ * or leave in one call share a single map update. Called each physics frame by Terrain3D, with
+ * V3_MAX if there is no camera.
+ * Distances are measured from the region each focus point is in, so the regions to keep are only
+ * recalculated when a focus point enters another region. Other frames only poll the requests.
+ */
+void Terrain3DData::update_streaming(const Vector3 &p_camera_position) {
+	if (_terrain == nullptr || _region_size <= 0) {
+		return;
+	}
+	ResourceLoader *loader = ResourceLoader::get_singleton();
+	TypedArray<Vector2i> loaded;
+	TypedArray<Vector2i> unloaded;
+
+	// Add regions that finished loading
+	Array requests = _stream_requests.keys();
+	for (int i = 0; i < requests.size(); i++) {
+		Vector2i region_loc = requests[i];
+		String path = _stream_requests[region_loc];
+		ResourceLoader::ThreadLoadStatus status = loader->load_threaded_get_status(path);
+		if (status == ResourceLoader::THREAD_LOAD_IN_PROGRESS) {
+			continue;
+		}
+		_stream_requests.erase(region_loc);
+		Ref<Terrain3DRegion> region;
+		if (status != ResourceLoader::THREAD_LOAD_INVALID_RESOURCE) {
+			region = loader->load_threaded_get(path);
+		}
+		if (_regions.has(region_loc)) {
+			LOG(WARN, "Region ", region_loc, " was added while loading. Discarding ", path);
+			continue;
 		}
+		_stream_dirty = true;
+		if (_setup_loaded_region(region, region_loc, path) != OK || add_region(region, false) != OK) {
+			_stream_files.erase(region_loc); // Don't retry broken files
+			continue;
+		}
+		loaded.push_back(region_loc);
+	}
+
+	// Recalculate only if a focus point entered another region, or anything else changed
+	PackedVector3Array focus_points = _stream_focus_points;
+	if (focus_points.is_empty() && p_camera_position != V3_MAX) {
+		focus_points.push_back(p_camera_position);
+	}
+	std::vector<Vector2i> focus_regions;
+	focus_regions.reserve(focus_points.size());
+	for (int f = 0; f < focus_points.size(); f++) {
+		focus_regions.push_back(get_region_location(focus_points[f]));
+	}
+	real_t load_distance = _terrain->get_streaming_load_distance();
+	real_t unload_distance = MAX(load_distance, _terrain->get_streaming_unload_distance());
+	Vector3 settings = Vector3(load_distance, unload_distance, _terrain->get_streaming_memory_budget());
+	if (!_stream_dirty && focus_regions == _stream_focus_regions && settings == _stream_settings) {
+		return;
+	}
+	_stream_dirty = false;
+	_stream_focus_regions = focus_regions;
+	_stream_settings = settings;
+
+	// Find the regions to keep, nearest first, within the unload distance and memory budget
+	real_t region_width = real_t(_region_size) * _vertex_spacing;
+	_stream_nearby.clear();
+	_stream_keep.clear();
+	Array locations = _stream_files.keys();
+	for (int i = 0; i < locations.size(); i++) {
+		Vector2i region_loc = locations[i];
+		real_t distance = FLT_MAX;
+		for (const Vector2i &focus_loc : focus_regions) {
+			// Gap between the regions, in whole regions on each axis
+			Vector2i gap = (region_loc - focus_loc).abs() - V2I(1);
+			gap = Vector2i(MAX(gap.x, 0), MAX(gap.y, 0));
+			distance = MIN(distance, Vector2(gap).length() * region_width);
+		}
+		if (distance <= unload_distance) {
+			_stream_nearby.push_back({ distance, region_loc });
+		}
+	}
+	std::sort(_stream_nearby.begin(), _stream_nearby.end(), [](const std::pair<real_t, Vector2i> &a, const std::pair<real_t, Vector2i> &b) {
+		return a.first < b.first;
+	});
+	int64_t budget = int64_t(_terrain->get_streaming_memory_budget()) * 1024 * 1024;
+	if (budget > 0) {
+		// Height and control maps, plus the color map with mipmaps
+		int64_t region_bytes = int64_t(_region_size) * _region_size * (4 + 4 + 4 * 4 / 3);
+		size_t max_regions = size_t(MAX(budget / region_bytes, int64_t(1)));
+		if (_stream_nearby.size() > max_regions) {
+			LOG(DEBUG, "Streaming memory budget allows ", max_regions, " of ", _stream_nearby.size(), " nearby regions");
+			_stream_nearby.resize(max_regions);
+		}
+	}
+	for (const std::pair<real_t, Vector2i> &region : _stream_nearby) {
+		_stream_keep.insert(region.second);
+	}
+
+	// Unload streamed regions no longer kept, unless they have unsaved changes
+	TypedArray<Vector2i> active = _region_locations.duplicate();
+	for (int i = 0; i < active.size(); i++) {
+		Vector2i region_loc = active[i];
+		if (!_stream_files.has(region_loc) || _stream_keep.count(region_loc) > 0) {
+			continue;
+		}
+		Terrain3DRegion *region = get_region_ptr(region_loc);
+		if (region == nullptr || region->is_modified() || region->is_edited()) {
+			continue;
+		}
+		_unload_region(region_loc);
+		unloaded.push_back(region_loc);
+	}
+
+	// Request the nearest missing regions within the load distance
+	for (const std::pair<real_t, Vector2i> &region : _stream_nearby) {
+		if (region.first > load_distance || _stream_requests.size() >= STREAM_REQUEST_LIMIT) {
+			break;
+		}
+		Vector2i region_loc = region.second;
+		if (_regions.has(region_loc) || _stream_requests.has(region_loc)) {
+			continue;
+		}
+		String path = _stream_files[region_loc];
+		Error err = loader->load_threaded_request(path, "Terrain3DRegion", false, ResourceLoader::CACHE_MODE_IGNORE);
+		if (err != OK) {
+			LOG(ERROR, "Cannot request region ", path, ", error: ", UtilityFunctions::error_string(err));
+			_stream_files.erase(region_loc);
+			continue;
+		}
+		LOG(DEBUG, "Requested region ", region_loc, " from ", path);
+		_stream_requests[region_loc] = path;
+	}
+
+	if (loaded.is_empty() && unloaded.is_empty()) {
+		return;
+	}
+	LOG(INFO, "Streamed in ", loaded.size(), " regions, out ", unloaded.size(), ", pending ", _stream_requests.size());
+	update_maps();
+	for (int i = 0; i < loaded.size(); i++) {
+		_terrain->get_instancer()->_update_mmis(loaded[i]);
+		emit_signal("region_loaded", loaded[i]);
+	}
+	for (int i = 0; i < unloaded.size(); i++) {
+		emit_signal("region_unloaded", unloaded[i]);
 	}
-	region->take_over_path(path);
-	region->set_location(p_region_loc);
-	region->set_version(CURRENT_VERSION); // Sends upgrade warning if old version
-	add_region(region, p_update);
 }
 
 TypedArray<Image> Terrain3DData::get_maps(const MapType p_map_type) const {
@@ -467,8 +1517,7 @@ void Terrain3DData::force_update_maps(const MapType p_map_type, const bool p_gen
 	if (p_generate_mipmaps && (p_map_type == TYPE_COLOR || p_map_type == TYPE_MAX)) {
 		LOG(EXTREME, "Regenerating color mipmaps");
 		for (int i = 0; i < _region_locations.size(); i++) {
-			Vector2i region_loc = _region_locations[i];
-			Ref<Terrain3DRegion> region = get_region(region_loc);
+			Terrain3DRegion *region = get_region_ptr(_region_locations[i]);
 			region->get_color_map()->generate_mipmaps();
 		}
 	}
@@ -477,74 +1526,53 @@ void Terrain3DData::force_update_maps(const MapType p_map_type, const bool p_gen
 
 void Terrain3DData::update_maps(const MapType p_map_type) {
 	bool any_changed = false;
+	_height_sampler.unref();
 
 	if (_region_map_dirty) {
 		LOG(EXTREME, "Regenerating ", REGION_MAP_VSIZE, " region map array from active regions");
-		_region_map.clear();
-		_region_map.resize(REGION_MAP_SIZE * REGION_MAP_SIZE);
-		_region_map_dirty = false;
-		_region_locations = TypedArray<Vector2i>(); // enforce new pointer
-		Array locs = _regions.keys();
-		int region_id = 0;
-		for (int i = 0; i < locs.size(); i++) {
-			Ref<Terrain3DRegion> region = get_region(locs[i]);
-			if (region.is_valid() && !region->is_deleted()) {
-				region_id += 1; // Begin at 1 since 0 = no region
-				int map_index = get_region_map_index(region->get_location());
-				if (map_index >= 0) {
-					_region_map[map_index] = region_id;
-					_region_locations.push_back(region->get_location());
-				}
-			}
-		}
+		_update_region_layers();
 		any_changed = true;
 		emit_signal("region_map_changed");
 	}
 
+	bool layers_changed = any_changed;
+	bool rebuild_all = _generated_height_maps.is_dirty() && _generated_control_maps.is_dirty() && _generated_color_maps.is_dirty();
+	if (rebuild_all) {
+		// Rebuilding all arrays is the time to resize them, and to close gaps left by removed regions
+		_compact_region_layers();
+	}
+	if (layers_changed || _generated_height_maps.is_dirty() || _generated_control_maps.is_dirty() || _generated_color_maps.is_dirty()) {
+		if (!_update_map_arrays()) {
+			return;
+		}
+	}
+
 	if (_generated_height_maps.is_dirty()) {
 		LOG(EXTREME, "Regenerating height texture array from regions");
-		_height_maps.clear();
-		for (int i = 0; i < _region_locations.size(); i++) {
-			Vector2i region_loc = _region_locations[i];
-			Ref<Terrain3DRegion> region = get_region(region_loc);
-			if (region.is_valid()) {
-				_height_maps.push_back(region->get_height_map());
-			} else {
-				LOG(ERROR, "Can't find region ", region_loc, ", _regions: ", _regions,
-						", locations: ", _region_locations, ". Please report this error.");
-				return;
-			}
-		}
-		_generated_height_maps.create(_height_maps);
-		calc_height_range();
+		_generated_height_maps.create(_get_layer_images(TYPE_HEIGHT));
 		any_changed = true;
+	}
+	if (any_changed) {
+		calc_height_range();
 		emit_signal("height_maps_changed");
 	}
 
 	if (_generated_control_maps.is_dirty()) {
 		LOG(EXTREME, "Regenerating control texture array from regions");
-		_control_maps.clear();
-		for (int i = 0; i < _region_locations.size(); i++) {
-			Vector2i region_loc = _region_locations[i];
-			Ref<Terrain3DRegion> region = get_region(region_loc);
-			_control_maps.push_back(region->get_control_map());
-		}
-		_generated_control_maps.create(_control_maps);
+		_generated_control_maps.create(_get_layer_images(TYPE_CONTROL));
 		any_changed = true;
 		emit_signal("control_maps_changed");
+	} else if (layers_changed) {
+		emit_signal("control_maps_changed");
 	}
 
 	if (_generated_color_maps.is_dirty()) {
 		LOG(EXTREME, "Regenerating color texture array from regions");
-		_color_maps.clear();
-		for (int i = 0; i < _region_locations.size(); i++) {
-			Vector2i region_loc = _region_locations[i];
-			Ref<Terrain3DRegion> region = get_region(region_loc);
-			_color_maps.push_back(region->get_color_map());
-		}
-		_generated_color_maps.create(_color_maps);
+		_generated_color_maps.create(_get_layer_images(TYPE_COLOR));
 		any_changed = true;
 		emit_signal("color_maps_changed");
+	} else if (layers_changed) {
+		emit_signal("color_maps_changed");
 	}
 
 	if (!any_changed) {
@@ -552,26 +1580,26 @@ void Terrain3DData::update_maps(const MapType p_map_type) {
 		// have either been recently changed by Terrain3DEditor::_operate_map or were marked by undo / redo.
 		for (int i = 0; i < _region_locations.size(); i++) {
 			Vector2i region_loc = _region_locations[i];
-			Ref<Terrain3DRegion> region = _regions[region_loc];
-			if (region->is_edited()) {
+			Terrain3DRegion *region = get_region_ptr(region_loc);
+			if (region && region->is_edited()) {
 				int region_id = get_region_id(region_loc);
 				switch (p_map_type) {
 					case TYPE_HEIGHT:
-						_generated_height_maps.update(region->get_height_map(), region_id);
+						_generated_height_maps.queue_update(region->get_height_map(), region_id);
 						emit_signal("height_maps_changed");
 						break;
 					case TYPE_CONTROL:
-						_generated_control_maps.update(region->get_control_map(), region_id);
+						_generated_control_maps.queue_update(region->get_control_map(), region_id);
 						emit_signal("control_maps_changed");
 						break;
 					case TYPE_COLOR:
-						_generated_color_maps.update(region->get_color_map(), region_id);
+						_generated_color_maps.queue_update(region->get_color_map(), region_id);
 						emit_signal("color_maps_changed");
 						break;
 					default:
-						_generated_height_maps.update(region->get_height_map(), region_id);
-						_generated_control_maps.update(region->get_control_map(), region_id);
-						_generated_color_maps.update(region->get_color_map(), region_id);
+						_generated_height_maps.queue_update(region->get_height_map(), region_id);
+						_generated_control_maps.queue_update(region->get_control_map(), region_id);
+						_generated_color_maps.queue_update(region->get_color_map(), region_id);
 						emit_signal("height_maps_changed");
 						emit_signal("control_maps_changed");
 						emit_signal("color_maps_changed");
@@ -580,6 +1608,12 @@ void Terrain3DData::update_maps(const MapType p_map_type) {
 			}
 		}
 	}
+	// Queued layers, from edits or regions added to free layers, are uploaded once per frame by _upload_maps()
+	if (!_map_upload_queued && (_generated_height_maps.has_queued_updates() ||
+										_generated_control_maps.has_queued_updates() || _generated_color_maps.has_queued_updates())) {
+		_map_upload_queued = true;
+		callable_mp(this, &Terrain3DData::_upload_maps).call_deferred();
+	}
 	emit_signal("maps_changed");
 }
 
@@ -589,8 +1623,8 @@ void Terrain3DData::set_pixel(const MapType p_map_type, const Vector3 &p_global_
 		return;
 	}
 	Vector2i region_loc = get_region_location(p_global_position);
-	Ref<Terrain3DRegion> region = get_region(region_loc);
-	if (region.is_null()) {
+	Terrain3DRegion *region = get_region_ptr(region_loc);
+	if (region == nullptr) {
 		LOG(ERROR, "No active region found at: ", p_global_position);
 		return;
 	}
@@ -602,8 +1636,11 @@ void Terrain3DData::set_pixel(const MapType p_map_type, const Vector3 &p_global_
 	Vector3 descaled_pos = p_global_position / _vertex_spacing;
 	Vector2i img_pos = Vector2i(descaled_pos.x - global_offset.x, descaled_pos.z - global_offset.y);
 	img_pos = img_pos.clamp(V2I_ZERO, Vector2i(_region_size - 1, _region_size - 1));
-	Ref<Image> map = region->get_map(p_map_type);
-	map->set_pixelv(img_pos, p_pixel);
+	region->get_map_ptr(p_map_type)->set_pixelv(img_pos, p_pixel);
+	if (p_map_type != TYPE_COLOR) {
+		region->update_height_pyramid(Rect2i(img_pos, V2I(1)));
+		_height_sampler.unref(); // Holds the maps before the edit
+	}
 	region->set_modified(true);
 }
 
@@ -613,8 +1650,8 @@ Color Terrain3DData::get_pixel(const MapType p_map_type, const Vector3 &p_global
 		return COLOR_NAN;
 	}
 	Vector2i region_loc = get_region_location(p_global_position);
-	Ref<Terrain3DRegion> region = get_region(region_loc);
-	if (region.is_null()) {
+	const Terrain3DRegion *region = get_region_ptr(region_loc);
+	if (region == nullptr) {
 		return COLOR_NAN;
 	}
 	if (region->is_deleted()) {
@@ -624,8 +1661,7 @@ Color Terrain3DData::get_pixel(const MapType p_map_type, const Vector3 &p_global
 	Vector3 descaled_pos = p_global_position / _vertex_spacing;
 	Vector2i img_pos = Vector2i(descaled_pos.x - global_offset.x, descaled_pos.z - global_offset.y);
 	img_pos = img_pos.clamp(V2I_ZERO, Vector2i(_region_size - 1, _region_size - 1));
-	Ref<Image> map = region->get_map(p_map_type);
-	return map->get_pixelv(img_pos);
+	return region->get_map_ptr(p_map_type)->get_pixelv(img_pos);
 }
 
 real_t Terrain3DData::get_height(const Vector3 &p_global_position) const {
@@ -666,6 +1702,143 @@ Vector3 Terrain3DData::get_normal(const Vector3 &p_global_position) const {
 	return normal;
 }
 
+/**
+ * Returns the heights of many positions at once, matching get_height() for each, including NAN
+ * for holes and positions outside of regions. The region is resolved once for each run of
+ * positions that fall within it, and heights are read directly from the map buffers.
+ */
+PackedFloat32Array Terrain3DData::get_heights(const PackedVector3Array &p_global_positions) const {
+	PackedFloat32Array heights;
+	int count = p_global_positions.size();
+	heights.resize(count);
+	if (count == 0) {
+		return heights;
+	}
+	if (_region_size <= 0) {
+		heights.fill(NAN);
+		return heights;
+	}
+	const Vector3 *positions = p_global_positions.ptr();
+	float *out = heights.ptrw();
+
+	// Raw buffers of the most recently used region
+	Vector2i cached_loc = V2I_MAX;
+	PackedByteArray height_data;
+	PackedByteArray control_data;
+	const float *height_ptr = nullptr;
+	const uint32_t *control_ptr = nullptr;
+	const int map_bytes = _region_size * _region_size * sizeof(float);
+
+	// Points the cache at the region containing the descaled pixel and returns the pixel's index
+	// into its maps, or -1 if there is no active region there.
+	auto get_index = [&](const Vector2i &p_pixel) -> int {
+		Vector2i region_loc = V2I_DIVIDE_FLOOR(p_pixel, _region_size);
+		if (region_loc != cached_loc) {
+			cached_loc = region_loc;
+			height_ptr = nullptr;
+			control_ptr = nullptr;
+			const Terrain3DRegion *region = get_region_ptr(region_loc);
+			if (region && !region->is_deleted()) {
+				height_data = region->get_height_map()->get_data();
+				control_data = region->get_control_map()->get_data();
+				if (height_data.size() >= map_bytes && control_data.size() >= map_bytes) {
+					height_ptr = reinterpret_cast<const float *>(height_data.ptr());
+					control_ptr = reinterpret_cast<const uint32_t *>(control_data.ptr());
+				}
+			}
+		}
+		if (height_ptr == nullptr) {
+			return -1;
+		}
+		Vector2i img_pos = p_pixel - region_loc * _region_size;
+		return img_pos.y * _region_size + img_pos.x;
+	};
+
+	auto get_vertex_height = [&](const Vector2i &p_pixel) -> real_t {
+		int index = get_index(p_pixel);
+		return (index < 0) ? NAN : height_ptr[index];
+	};
+
+	for (int i = 0; i < count; i++) {
+		Vector2 pos = Vector2(positions[i].x, positions[i].z) / _vertex_spacing;
+		Vector2 pos00 = pos.floor();
+		Vector2i pixel = Vector2i(pos00);
+		// Holes are read from the pixel containing the position, as in get_control()
+		int index = get_index(pixel);
+		if (index < 0 || is_hole(control_ptr[index])) {
+			out[i] = NAN;
+			continue;
+		}
+		// If requested position is close to a vertex, return its height
+		Vector2 pos_round = pos.round();
+		if ((pos - pos_round).length() * _vertex_spacing < 0.01f) {
+			out[i] = get_vertex_height(Vector2i(pos_round));
+		} else {
+			// Otherwise, bilinearly interpolate 4 surrounding vertices
+			real_t ht00 = height_ptr[index];
+			real_t ht01 = get_vertex_height(pixel + Vector2i(0, 1));
+			real_t ht10 = get_vertex_height(pixel + Vector2i(1, 0));
+			real_t ht11 = get_vertex_height(pixel + Vector2i(1, 1));
+			out[i] = bilerp(ht00, ht01, ht10, ht11, pos00, pos00 + Vector2(1.f, 1.f), pos);
+		}
+	}
+	return heights;
+}
+
+// Returns the normals of many positions at once, matching get_normal() for each.
+PackedVector3Array Terrain3DData::get_normals(const PackedVector3Array &p_global_positions) const {
+	PackedVector3Array normals;
+	int count = p_global_positions.size();
+	normals.resize(count);
+	if (count == 0) {
+		return normals;
+	}
+	// Interleave each position with its +X and +Z neighbors so they share the region cache
+	PackedVector3Array samples;
+	samples.resize(count * 3);
+	Vector3 *samples_ptr = samples.ptrw();
+	const Vector3 *positions = p_global_positions.ptr();
+	for (int i = 0; i < count; i++) {
+		samples_ptr[i * 3] = positions[i];
+		samples_ptr[i * 3 + 1] = positions[i] + Vector3(_vertex_spacing, 0.f, 0.f);
+		samples_ptr[i * 3 + 2] = positions[i] + Vector3(0.f, 0.f, _vertex_spacing);
+	}
+	PackedFloat32Array heights = get_heights(samples);
+	const float *heights_ptr = heights.ptr();
+	Vector3 *out = normals.ptrw();
+	for (int i = 0; i < count; i++) {
+		real_t height = heights_ptr[i * 3];
+		if (std::isnan(height)) {
+			out[i] = Vector3(NAN, NAN, NAN);
+			continue;
+		}
+		real_t u = height - heights_ptr[i * 3 + 1];
+		real_t v = height - heights_ptr[i * 3 + 2];
+		Vector3 normal = Vector3(u, _vertex_spacing, v);
+		normal.normalize();
+		out[i] = normal;
+	}
+	return normals;
+}
+
+// Returns a snapshot of the active height and control maps that can be read from any thread.
+// The snapshot is cached until the maps are edited or updated, or regions change.
+Ref<Terrain3DHeightSampler> Terrain3DData::get_height_sampler() const {
+	if (_height_sampler.is_valid()) {
+		return _height_sampler;
+	}
+	Ref<Terrain3DHeightSampler> sampler;
+	sampler.instantiate();
+	sampler->_region_size = _region_size;
+	sampler->_vertex_spacing = _vertex_spacing;
+	for (int i = 0; i < _region_locations.size(); i++) {
+		sampler->_add_region(get_region_ptr(_region_locations[i]));
+	}
+	LOG(DEBUG, "Created height sampler with ", sampler->get_region_count(), " regions");
+	_height_sampler = sampler;
+	return sampler;
+}
+
 bool Terrain3DData::is_in_slope(const Vector3 &p_global_position, const Vector2 &p_slope_range, const bool p_invert) const {
 	// If slope is full range, it's disabled
 	const Vector2 slope_range = CLAMP(p_slope_range, V2_ZERO, Vector2(90.f, 90.f));
@@ -778,17 +1951,27 @@ Vector3 Terrain3DData::get_mesh_vertex(const int32_t p_lod, const HeightFilter p
 		} break;
 		case HEIGHT_FILTER_MINIMUM: {
 			height = get_height(p_global_position);
-			for (int32_t dx = -step / 2; dx < step / 2; dx += 1) {
-				for (int32_t dz = -step / 2; dz < step / 2; dz += 1) {
-					Vector3 position = p_global_position + Vector3(dx, 0.f, dz) * _vertex_spacing;
-					if (is_hole(get_control(position))) {
+			if (step == 1 || std::isnan(height)) {
+				break;
+			}
+			// Query the height pyramids of all regions under the step x step vertices around the position
+			Vector2i pixel = Vector2i((Vector2(p_global_position.x, p_global_position.z) / _vertex_spacing).floor());
+			Rect2i area = Rect2i(pixel - V2I(step / 2), V2I(step));
+			Vector2i start = V2I_DIVIDE_FLOOR(area.position, _region_size);
+			Vector2i end = V2I_DIVIDE_FLOOR(area.get_end() - V2I(1), _region_size);
+			for (int y = start.y; y <= end.y && !std::isnan(height); y++) {
+				for (int x = start.x; x <= end.x; x++) {
+					Vector2i region_loc = Vector2i(x, y);
+					Terrain3DRegion *region = get_region_ptr(region_loc);
+					Vector2 range;
+					bool hole = true;
+					if (region == nullptr || region->is_deleted() ||
+							!region->query_height_pyramid(Rect2i(area.position - region_loc * _region_size, area.size), range, hole) ||
+							hole) {
 						height = NAN;
 						break;
 					}
-					real_t h = get_height(position);
-					if (h < height) {
-						height = h;
-					}
+					height = MIN(height, range.x);
 				}
 			}
 		} break;
@@ -796,12 +1979,32 @@ Vector3 Terrain3DData::get_mesh_vertex(const int32_t p_lod, const HeightFilter p
 	return Vector3(p_global_position.x, height, p_global_position.z);
 }
 
+// Updates the height pyramids of regions under the area, then accumulates it for the instancer,
+// collision, and other consumers
 void Terrain3DData::add_edited_area(const AABB &p_area) {
+	Rect2 rect = aabb2rect(p_area);
+	Vector2i start = Vector2i((rect.position / _vertex_spacing).floor()) - V2I(1);
+	Vector2i end = Vector2i((rect.get_end() / _vertex_spacing).ceil()) + V2I(1);
+	if (_region_size > 0) {
+		Vector2i region_start = V2I_DIVIDE_FLOOR(start, _region_size);
+		Vector2i region_end = V2I_DIVIDE_FLOOR(end, _region_size);
+		for (int y = region_start.y; y <= region_end.y; y++) {
+			for (int x = region_start.x; x <= region_end.x; x++) {
+				Terrain3DRegion *region = get_region_ptr(Vector2i(x, y));
+				if (region) {
+					Vector2i offset = Vector2i(x, y) * _region_size;
+					region->update_height_pyramid(Rect2i(start - offset, end - start + V2I(1)));
+				}
+			}
+		}
+	}
+
 	if (_edited_area.has_surface()) {
 		_edited_area = _edited_area.merge(p_area);
 	} else {
 		_edited_area = p_area;
 	}
+	_height_sampler.unref();
 	emit_signal("maps_edited", p_area);
 }
 
@@ -811,8 +2014,8 @@ void Terrain3DData::calc_height_range(const bool p_recursive) {
 	_master_height_range = V2_ZERO;
 	for (int i = 0; i < _region_locations.size(); i++) {
 		Vector2i region_loc = _region_locations[i];
-		Ref<Terrain3DRegion> region = get_region(region_loc);
-		if (region.is_null()) {
+		Terrain3DRegion *region = get_region_ptr(region_loc);
+		if (region == nullptr) {
 			LOG(ERROR, "Region not found at: ", region_loc);
 			return;
 		}
@@ -951,6 +2154,88 @@ void Terrain3DData::import_images(const TypedArray<Image> &p_images, const Vecto
 	} // for y < slices_height, x < slices_width
 }
 
+/**
+ * Imports a height map from an r16/raw or OpenEXR scanline file without loading the whole image.
+ * Each region is read from the file in its own worker task and written straight into its height
+ * map, so memory use beyond the new regions is a few region sized buffers. Other formats, and
+ * EXR files that are tiled or use other compression, fall back to import_images().
+ */
+Error Terrain3DData::import_height_file(const String &p_file_name, const Vector3 &p_global_position, const real_t p_offset,
+		const real_t p_scale, const Vector2 &p_r16_height_range, const Vector2i &p_r16_size) {
+	IS_INIT_MESG("Data not initialized", FAILED);
+	if (!FileAccess::file_exists(p_file_name)) {
+		LOG(ERROR, "File ", p_file_name, " does not exist. Nothing to import");
+		return ERR_FILE_NOT_FOUND;
+	}
+	Error err = _open_height_file(p_file_name, p_r16_height_range, p_r16_size);
+	if (err == ERR_FILE_UNRECOGNIZED) {
+		LOG(WARN, "Cannot stream ", p_file_name, ". Loading the whole image with import_images()");
+		Ref<Image> img = Util::load_image(p_file_name, ResourceLoader::CACHE_MODE_IGNORE, p_r16_height_range, p_r16_size);
+		if (img.is_null()) {
+			return ERR_FILE_CANT_READ;
+		}
+		TypedArray<Image> images;
+		images.resize(TYPE_MAX);
+		images[TYPE_HEIGHT] = img;
+		import_images(images, p_global_position, p_offset, p_scale);
+		return OK;
+	} else if (err != OK) {
+		return err;
+	}
+
+	Vector2i img_size = _import_file.size;
+	LOG(INFO, "Importing height file: ", p_file_name, ", size: ", img_size, ", offset: ", p_offset, ", scale: ", p_scale);
+	Vector3 descaled_position = p_global_position / _vertex_spacing;
+	int max_dimension = _region_size * REGION_MAP_SIZE / 2;
+	if ((abs(descaled_position.x) > max_dimension) || (abs(descaled_position.z) > max_dimension)) {
+		LOG(ERROR, "Specify a position within +/-", Vector3(max_dimension, 0.f, max_dimension) * _vertex_spacing);
+		return ERR_PARAMETER_RANGE_ERROR;
+	}
+	if ((descaled_position.x + img_size.x > max_dimension) ||
+			(descaled_position.z + img_size.y > max_dimension)) {
+		LOG(ERROR, img_size, " image will not fit at ", p_global_position,
+				". Try ", -(img_size * _vertex_spacing) / 2.f, " to center");
+		return ERR_PARAMETER_RANGE_ERROR;
+	}
+
+	uint64_t start_time = Time::get_singleton()->get_ticks_usec();
+	Vector2i slices = V2I_DIVIDE_CEIL(img_size, _region_size);
+	_imports.clear();
+	_imports.resize(slices.x * slices.y);
+	for (int y = 0; y < slices.y; y++) {
+		for (int x = 0; x < slices.x; x++) {
+			HeightImport &region_import = _imports[y * slices.x + x];
+			Vector2i start_coords = Vector2i(x, y) * _region_size;
+			Vector2i remainder = img_size - start_coords;
+			region_import.rect = Rect2i(start_coords, Vector2i(MIN(remainder.x, _region_size), MIN(remainder.y, _region_size)));
+			Vector3 position = Vector3(descaled_position.x + start_coords.x, 0.f, descaled_position.z + start_coords.y);
+			region_import.region_loc = get_region_location(position * _vertex_spacing);
+		}
+	}
+	_import_offset = p_offset;
+	_import_scale = p_scale;
+	LOG(DEBUG, "Reading ", slices, " regions from ", img_size, " file");
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int64_t group_id = pool->add_group_task(callable_mp(this, &Terrain3DData::_import_height_task), _imports.size(), -1, true, "Terrain3D import height");
+	pool->wait_for_group_task_completion(group_id);
+
+	int failed = 0;
+	for (const HeightImport &region_import : _imports) {
+		if (region_import.error != OK || region_import.region.is_null()) {
+			LOG(ERROR, "Could not read ", region_import.rect, " of ", p_file_name, ", error: ", UtilityFunctions::error_string(region_import.error));
+			failed++;
+			continue;
+		}
+		add_region(region_import.region, false);
+	}
+	_imports.clear();
+	_import_file = HeightFile();
+	update_maps();
+	_terrain->get_instancer()->force_update_mmis();
+	LOG(MESG, "Imported ", slices.x * slices.y - failed, " regions in ", (Time::get_singleton()->get_ticks_usec() - start_time) / 1000, "ms");
+	return (failed > 0) ? ERR_FILE_CORRUPT : OK;
+}
+
 /** Exports a specified map as one of r16/raw, exr, jpg, png, webp, res, tres
  * r16 or exr are recommended for roundtrip external editing
  * r16 can be edited by Krita, however you must know the dimensions and min/max before reimporting
@@ -1007,33 +2292,23 @@ Error Terrain3DData::export_image(const String &p_file_name, const MapType p_map
 	}
 	file_ref->close();
 
-	// Filename is validated. Begin export image generation
+	// Filename is validated. r16 and float maps to EXR are written one row of regions at a time
+	String ext = file_name.get_extension().to_lower();
+	if (ext == "r16" || ext == "raw" || (ext == "exr" && FORMAT[p_map_type] == Image::FORMAT_RF)) {
+		return _export_map_rows(file_name, p_map_type, ext == "exr");
+	}
+
+	// Other formats are encoded from one image of all regions
 	Ref<Image> img = layered_to_image(p_map_type);
 	if (img.is_null() || img->is_empty()) {
 		LOG(ERROR, "Cannot create an export image for map type: ", TYPESTR[p_map_type]);
 		return FAILED;
 	}
 
-	String ext = file_name.get_extension().to_lower();
 	LOG(MESG, "Saving ", img->get_size(), " sized ", TYPESTR[p_map_type],
 			" map in format ", img->get_format(), " as ", ext, " to: ", file_name);
-	Vector2i minmax = Util::get_min_max(img);
-	LOG(MESG, "Minimum height: ", minmax.x, ", Maximum height: ", minmax.y);
-	if (ext == "r16" || ext == "raw") {
-		Ref<FileAccess> file = FileAccess::open(file_name, FileAccess::WRITE);
-		real_t height_min = minmax.x;
-		real_t height_max = minmax.y;
-		real_t hscale = 65535.0 / (height_max - height_min);
-		for (int y = 0; y < img->get_height(); y++) {
-			for (int x = 0; x < img->get_width(); x++) {
-				int h = int((img->get_pixel(x, y).r - height_min) * hscale);
-				h = CLAMP(h, 0, 65535);
-				file->store_16(h);
-			}
-		}
-		return file->get_error();
-	} else if (ext == "exr") {
-		return img->save_exr(file_name, (p_map_type == TYPE_HEIGHT) ? true : false);
+	if (ext == "exr") {
+		return img->save_exr(file_name, false);
 	} else if (ext == "png") {
 		return img->save_png(file_name);
 	} else if (ext == "jpg") {
@@ -1054,25 +2329,9 @@ Ref<Image> Terrain3DData::layered_to_image(const MapType p_map_type) const {
 	if (map_type >= TYPE_MAX) {
 		map_type = TYPE_HEIGHT;
 	}
-	Vector2i top_left = V2I_ZERO;
-	Vector2i bottom_right = V2I_ZERO;
-	for (int i = 0; i < _region_locations.size(); i++) {
-		LOG(DEBUG, "Region locations[", i, "]: ", _region_locations[i]);
-		Vector2i region_loc = _region_locations[i];
-		if (region_loc.x < top_left.x) {
-			top_left.x = region_loc.x;
-		} else if (region_loc.x > bottom_right.x) {
-			bottom_right.x = region_loc.x;
-		}
-		if (region_loc.y < top_left.y) {
-			top_left.y = region_loc.y;
-		} else if (region_loc.y > bottom_right.y) {
-			bottom_right.y = region_loc.y;
-		}
-	}
-
-	LOG(DEBUG, "Full range to cover all regions: ", top_left, " to ", bottom_right);
-	Vector2i img_size = Vector2i(1 + bottom_right.x - top_left.x, 1 + bottom_right.y - top_left.y) * _region_size;
+	Rect2i bounds = _get_region_bounds();
+	Vector2i top_left = bounds.position;
+	Vector2i img_size = bounds.size * _region_size;
 	LOG(DEBUG, "Image size: ", img_size);
 	Ref<Image> img = Util::get_filled_image(img_size, COLOR[map_type], false, FORMAT[map_type]);
 
@@ -1080,7 +2339,7 @@ Ref<Image> Terrain3DData::layered_to_image(const MapType p_map_type) const {
 		Vector2i region_loc = _region_locations[i];
 		Vector2i img_location = (region_loc - top_left) * _region_size;
 		LOG(DEBUG, "Region to blit: ", region_loc, " Export image coords: ", img_location);
-		Ref<Terrain3DRegion> region = get_region(region_loc);
+		const Terrain3DRegion *region = get_region_ptr(region_loc);
 		img->blit_rect(region->get_map(map_type), Rect2i(V2I_ZERO, _region_sizev), img_location);
 	}
 	return img;
@@ -1117,6 +2376,8 @@ void Terrain3DData::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_region_count"), &Terrain3DData::get_region_count);
 	ClassDB::bind_method(D_METHOD("set_region_locations", "region_locations"), &Terrain3DData::set_region_locations);
 	ClassDB::bind_method(D_METHOD("get_region_locations"), &Terrain3DData::get_region_locations);
+	ClassDB::bind_method(D_METHOD("get_layer_locations"), &Terrain3DData::get_layer_locations);
+	ClassDB::bind_method(D_METHOD("get_layer_capacity"), &Terrain3DData::get_layer_capacity);
 	ClassDB::bind_method(D_METHOD("get_regions_active", "copy", "deep"), &Terrain3DData::get_regions_active, DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_regions_all"), &Terrain3DData::get_regions_all);
 	ClassDB::bind_method(D_METHOD("get_region_map"), &Terrain3DData::get_region_map);
@@ -1149,7 +2410,14 @@ void Terrain3DData::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("save_directory", "directory"), &Terrain3DData::save_directory);
 	ClassDB::bind_method(D_METHOD("save_region", "region_location", "directory", "16_bit"), &Terrain3DData::save_region, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("load_directory", "directory"), &Terrain3DData::load_directory);
+	ClassDB::bind_method(D_METHOD("load_directory_async", "directory"), &Terrain3DData::load_directory_async);
 	ClassDB::bind_method(D_METHOD("load_region", "region_location", "directory", "update"), &Terrain3DData::load_region, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_loading"), &Terrain3DData::is_loading);
+	ClassDB::bind_method(D_METHOD("is_saving"), &Terrain3DData::is_saving);
+
+	ClassDB::bind_method(D_METHOD("set_streaming_focus_points", "points"), &Terrain3DData::set_streaming_focus_points);
+	ClassDB::bind_method(D_METHOD("get_streaming_focus_points"), &Terrain3DData::get_streaming_focus_points);
+	ClassDB::bind_method(D_METHOD("get_streaming_pending_count"), &Terrain3DData::get_streaming_pending_count);
 
 	ClassDB::bind_method(D_METHOD("get_height_maps"), &Terrain3DData::get_height_maps);
 	ClassDB::bind_method(D_METHOD("get_control_maps"), &Terrain3DData::get_control_maps);
@@ -1189,6 +2457,9 @@ void Terrain3DData::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_control_auto", "global_position"), &Terrain3DData::get_control_auto);
 
 	ClassDB::bind_method(D_METHOD("get_normal", "global_position"), &Terrain3DData::get_normal);
+	ClassDB::bind_method(D_METHOD("get_heights", "global_positions"), &Terrain3DData::get_heights);
+	ClassDB::bind_method(D_METHOD("get_normals", "global_positions"), &Terrain3DData::get_normals);
+	ClassDB::bind_method(D_METHOD("get_height_sampler"), &Terrain3DData::get_height_sampler);
 	ClassDB::bind_method(D_METHOD("is_in_slope", "global_position", "slope_range", "invert"), &Terrain3DData::is_in_slope, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_texture_id", "global_position"), &Terrain3DData::get_texture_id);
 	ClassDB::bind_method(D_METHOD("get_mesh_vertex", "lod", "filter", "global_position"), &Terrain3DData::get_mesh_vertex);
@@ -1197,6 +2468,7 @@ void Terrain3DData::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("calc_height_range", "recursive"), &Terrain3DData::calc_height_range, DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("import_images", "images", "global_position", "offset", "scale"), &Terrain3DData::import_images, DEFVAL(Vector3(0, 0, 0)), DEFVAL(0.0), DEFVAL(1.0));
+	ClassDB::bind_method(D_METHOD("import_height_file", "file_name", "global_position", "offset", "scale", "r16_height_range", "r16_size"), &Terrain3DData::import_height_file, DEFVAL(Vector3(0, 0, 0)), DEFVAL(0.0), DEFVAL(1.0), DEFVAL(Vector2(0, 255)), DEFVAL(V2I_ZERO));
 	ClassDB::bind_method(D_METHOD("export_image", "file_name", "map_type"), &Terrain3DData::export_image);
 	ClassDB::bind_method(D_METHOD("layered_to_image", "map_type"), &Terrain3DData::layered_to_image);
 
@@ -1212,4 +2484,8 @@ void Terrain3DData::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("control_maps_changed"));
 	ADD_SIGNAL(MethodInfo("color_maps_changed"));
 	ADD_SIGNAL(MethodInfo("maps_edited", PropertyInfo(Variant::AABB, "edited_area")));
+	ADD_SIGNAL(MethodInfo("load_progress", PropertyInfo(Variant::INT, "regions_loaded"), PropertyInfo(Variant::INT, "region_count")));
+	ADD_SIGNAL(MethodInfo("region_loaded", PropertyInfo(Variant::VECTOR2I, "region_location")));
+	ADD_SIGNAL(MethodInfo("region_unloaded", PropertyInfo(Variant::VECTOR2I, "region_location")));
+	ADD_SIGNAL(MethodInfo("save_finished", PropertyInfo(Variant::INT, "regions_saved"), PropertyInfo(Variant::INT, "regions_failed")));
 }
@@ -3,11 +3,18 @@
 #ifndef TERRAIN3D_DATA_CLASS_H
 #define TERRAIN3D_DATA_CLASS_H
 
+#include <godot_cpp/classes/file_access.hpp>
+#include <atomic>
+#include <set>
+#include <vector>
+
 #include "constants.h"
 #include "generated_texture.h"
+#include "terrain_3d_height_sampler.h"
 #include "terrain_3d_region.h"
 
 class Terrain3D;
+class Terrain3DEditor;
 
 using namespace godot;
 
@@ -15,11 +22,15 @@ class Terrain3DData : public Object {
 	GDCLASS(Terrain3DData, Object);
 	CLASS_NAME();
 	friend Terrain3D;
+	friend Terrain3DEditor;
 
 public: // Constants
-	static inline const real_t CURRENT_VERSION = 0.93f;
+	static inline const real_t CURRENT_VERSION = 0.94f;
 	static inline const int REGION_MAP_SIZE = 32;
 	static inline const Vector2i REGION_MAP_VSIZE = Vector2i(REGION_MAP_SIZE, REGION_MAP_SIZE);
+	static inline const int STREAM_REQUEST_LIMIT = 4; // Regions loading at once, so the queue follows the camera
+	static inline const uint32_t EXR_MAGIC = 20000630;
+	static inline const int EXPORT_BUFFER_SIZE = 1 << 20; // Bytes of scanlines export_image() writes at once
 
 	enum HeightFilter {
 		HEIGHT_FILTER_NEAREST,
@@ -42,8 +53,9 @@ private:
 	// Regions are dual indexed:
 	// 1) By `region_location:Vector2i` as the primary key. This is the only stable index
 	// so should be the main index for users.
-	// 2) By `region_id:int`. This index changes on every add/remove, depends on load order,
-	// and is not stable. It should not be relied on by users and is primarily for internal use.
+	// 2) By `region_id:int`, the region's layer in the texture arrays. It is kept while the region
+	// stays active, but is reused after removal and reassigned when the arrays are compacted. It
+	// should not be relied on by users and is primarily for internal use.
 
 	// Private functions should be indexed by region_id or region_location
 	// Public functions by region_location or global_position
@@ -53,10 +65,15 @@ private:
 	// by the Undo system.
 	Dictionary _regions; // Dict[region_location:Vector2i] -> Terrain3DRegion
 
+	// 32x32 grid of raw pointers mirroring `_regions`, including regions marked for deletion.
+	// Indexed by get_region_map_index(), it provides lookups without hashing or refcounting.
+	// `_regions` owns the regions, so every change to it must also update this table.
+	std::array<Terrain3DRegion *, REGION_MAP_SIZE * REGION_MAP_SIZE> _region_slots = {};
+
 	// All _active_ region maps are maintained in these secondary indices.
 	// Regions are considered active if and only if they exist in `_region_locations`. The other
-	// arrays are built off of this index; its order defines region_id.
-	// The image arrays are converted to TextureArrays for the shader.
+	// arrays are built off of this index and follow its order. The image arrays are converted to
+	// TextureArrays for the shader, where each region is placed at its region_id layer.
 
 	TypedArray<Vector2i> _region_locations;
 	TypedArray<Image> _height_maps;
@@ -70,13 +87,114 @@ private:
 	PackedInt32Array _region_map;
 	bool _region_map_dirty = true;
 
+	// Each region keeps its region_id, its layer in the texture arrays, while it stays active.
+	// The arrays have _layer_capacity layers. Unused ones are on _free_layers, lowest last.
+	std::vector<Vector2i> _layer_locations; // Region location per layer, V2I_MAX if free
+	std::vector<uint64_t> _layer_regions; // Instance id of the region uploaded to each layer, 0 if none
+	std::vector<int> _free_layers;
+	int _layer_capacity = 0;
+
 	// These contain the TextureArray RIDs from the RenderingServer
 	GeneratedTexture _generated_height_maps;
 	GeneratedTexture _generated_control_maps;
 	GeneratedTexture _generated_color_maps;
+	bool _map_upload_queued = false;
+
+	// Snapshot shared by get_height_sampler() callers, dropped on map or region changes
+	mutable Ref<Terrain3DHeightSampler> _height_sampler;
+
+	// Region streaming, enabled by Terrain3D::streaming_enabled. Only regions with files listed
+	// here are loaded and unloaded by update_streaming(). Others, like new ones, stay resident.
+	Dictionary _stream_files; // Dict[region_location:Vector2i] -> path of region file in the data directory
+	Dictionary _stream_requests; // Dict[region_location:Vector2i] -> path loading on worker threads
+	PackedVector3Array _stream_focus_points;
+	// Regions to keep, nearest first, from the last pass. Redone only when a focus point enters
+	// another region, a request finishes, or the files or settings change.
+	std::vector<std::pair<real_t, Vector2i>> _stream_nearby;
+	std::set<Vector2i> _stream_keep;
+	std::vector<Vector2i> _stream_focus_regions;
+	Vector3 _stream_settings = V3_ZERO; // Load distance, unload distance, memory budget
+	bool _stream_dirty = true;
+
+	// Files decoded in parallel by load_directory_async(), one entry per worker task. Finished
+	// files are counted for update_loading() to report progress from the main thread.
+	struct RegionLoad {
+		Vector2i location;
+		String path;
+		Ref<Terrain3DRegion> region;
+	};
+	std::vector<RegionLoad> _loads;
+	int64_t _load_task_id = -1;
+	std::atomic<int> _loads_finished = 0;
+	int _loads_reported = 0;
+	uint64_t _load_start_time = 0;
+
+	// Files written by save_directory() on worker threads, one entry per task. Each writes a
+	// snapshot, so the live region can be edited meanwhile.
+	struct RegionSave {
+		String path;
+		Ref<Terrain3DRegion> region;
+		Ref<Terrain3DRegion> snapshot;
+		Error error = OK;
+	};
+	std::vector<RegionSave> _saves;
+	int64_t _save_task_id = -1;
+	bool _save_16_bit = false;
+
+	// Height file read by import_height_file(). Each worker task opens its own FileAccess and
+	// reads only the rows and columns of one region, so the whole image is never in memory.
+	struct HeightFile {
+		String path;
+		bool exr = false; // Else r16
+		Vector2i size = V2I_ZERO;
+		Vector2 r16_range = Vector2(0.f, 255.f);
+		// OpenEXR scanline layout
+		int compression = 0;
+		int lines_per_chunk = 1;
+		int64_t line_bytes = 0; // One uncompressed scanline of all channels
+		int64_t channel_offset = 0; // Start of the height channel within a scanline
+		int channel_type = 0; // 0 uint, 1 half, 2 float
+		std::vector<uint64_t> chunk_offsets;
+	};
+	struct HeightImport {
+		Vector2i region_loc = V2I_ZERO;
+		Rect2i rect; // Pixels of the file copied into this region
+		Ref<Terrain3DRegion> region;
+		Error error = OK;
+	};
+	HeightFile _import_file;
+	std::vector<HeightImport> _imports;
+	real_t _import_offset = 0.f;
+	real_t _import_scale = 1.f;
 
 	// Functions
 	void _clear();
+	void _store_region(const Ref<Terrain3DRegion> &p_region);
+	void _update_region_slots();
+	void _upload_maps();
+	void _update_region_layers();
+	void _compact_region_layers();
+	bool _update_map_arrays();
+	TypedArray<Image> _get_layer_images(const MapType p_map_type) const;
+	Error _setup_loaded_region(const Ref<Terrain3DRegion> &p_region, const Vector2i &p_region_loc, const String &p_path);
+	Error _list_region_files(const String &p_dir, Dictionary &r_files) const;
+	void _scan_directory(const String &p_dir);
+	void _load_region_task(const uint32_t p_index);
+	void _finish_load(const bool p_keep = true);
+	String _get_region_path(const Terrain3DRegion *p_region, const String &p_dir) const;
+	void _save_region_task(const uint32_t p_index);
+	void _finish_save(const bool p_notify = true);
+	void _update_file_system() const;
+	void _finish_stream_requests();
+	void _unload_region(const Vector2i &p_region_loc);
+	Error _open_height_file(const String &p_file_name, const Vector2 &p_r16_height_range, const Vector2i &p_r16_size);
+	Error _read_exr_header(const Ref<FileAccess> &p_file);
+	Error _decode_exr_chunk(const PackedByteArray &p_packed, const int64_t p_size, PackedByteArray &r_data) const;
+	Error _read_height_rows(const Ref<FileAccess> &p_file, const Rect2i &p_rect, float *r_heights, const int p_stride) const;
+	void _import_height_task(const uint32_t p_index);
+	Rect2i _get_region_bounds() const;
+	Error _export_map_rows(const String &p_file_name, const MapType p_map_type, const bool p_exr) const;
+	static void _remap_to_16_bit(const float *p_src, uint16_t *r_dst, const int p_count, const float p_min, const float p_scale);
 	void _copy_paste_dfr(const Terrain3DRegion *p_src_region, const Rect2i &p_src_rect, const Rect2i &p_dst_rect, const Terrain3DRegion *p_dst_region);
 
 public:
@@ -89,8 +207,10 @@ public:
 	int get_region_count() const { return _region_locations.size(); }
 	void set_region_locations(const TypedArray<Vector2i> &p_locations);
 	TypedArray<Vector2i> get_region_locations() const { return _region_locations; }
+	TypedArray<Vector2i> get_layer_locations() const;
+	int get_layer_capacity() const { return _layer_capacity; }
 	TypedArray<Terrain3DRegion> get_regions_active(const bool p_copy = false, const bool p_deep = false) const;
-	Dictionary get_regions_all() const { return _regions; }
+	Dictionary get_regions_all() const { return _regions.duplicate(); } // Region slots hold raw pointers, so _regions is not exposed
 	PackedInt32Array get_region_map() const { return _region_map; }
 	static int get_region_map_index(const Vector2i &p_region_loc);
 
@@ -105,6 +225,7 @@ public:
 	bool has_regionp(const Vector3 &p_global_position) const { return get_region_idp(p_global_position) != -1; }
 	Ref<Terrain3DRegion> get_region(const Vector2i &p_region_loc) const;
 	Ref<Terrain3DRegion> get_regionp(const Vector3 &p_global_position) const;
+	Terrain3DRegion *get_region_ptr(const Vector2i &p_region_loc) const;
 
 	void set_region_modified(const Vector2i &p_region_loc, const bool p_modified = true);
 	bool is_region_modified(const Vector2i &p_region_loc) const;
@@ -122,7 +243,18 @@ public:
 	void save_directory(const String &p_dir);
 	void save_region(const Vector2i &p_region_loc, const String &p_dir, const bool p_16_bit = false);
 	void load_directory(const String &p_dir);
+	void load_directory_async(const String &p_dir);
 	void load_region(const Vector2i &p_region_loc, const String &p_dir, const bool p_update = true);
+	bool is_loading() const { return _load_task_id >= 0; }
+	void update_loading();
+	bool is_saving() const { return _save_task_id >= 0; }
+	void update_saving();
+
+	// Streaming
+	void set_streaming_focus_points(const PackedVector3Array &p_points) { _stream_focus_points = p_points; }
+	PackedVector3Array get_streaming_focus_points() const { return _stream_focus_points; }
+	int get_streaming_pending_count() const { return _stream_requests.size(); }
+	void update_streaming(const Vector3 &p_camera_position = V3_MAX);
 
 	// Maps
 	TypedArray<Image> get_height_maps() const { return _height_maps; }
@@ -167,6 +299,9 @@ public:
 	bool get_control_auto(const Vector3 &p_global_position) const;
 
 	Vector3 get_normal(const Vector3 &p_global_position) const;
+	PackedFloat32Array get_heights(const PackedVector3Array &p_global_positions) const;
+	PackedVector3Array get_normals(const PackedVector3Array &p_global_positions) const;
+	Ref<Terrain3DHeightSampler> get_height_sampler() const;
 	bool is_in_slope(const Vector3 &p_global_position, const Vector2 &p_slope_range, const bool p_invert = false) const;
 	Vector3 get_texture_id(const Vector3 &p_global_position) const;
 	Vector3 get_mesh_vertex(const int32_t p_lod, const HeightFilter p_filter, const Vector3 &p_global_position) const;
@@ -182,6 +317,9 @@ public:
 
 	void import_images(const TypedArray<Image> &p_images, const Vector3 &p_global_position = V3_ZERO,
 			const real_t p_offset = 0.f, const real_t p_scale = 1.f);
+	Error import_height_file(const String &p_file_name, const Vector3 &p_global_position = V3_ZERO,
+			const real_t p_offset = 0.f, const real_t p_scale = 1.f,
+			const Vector2 &p_r16_height_range = Vector2(0.f, 255.f), const Vector2i &p_r16_size = V2I_ZERO);
 	Error export_image(const String &p_file_name, const MapType p_map_type = TYPE_HEIGHT) const;
 	Ref<Image> layered_to_image(const MapType p_map_type) const;
 
@@ -221,7 +359,7 @@ inline int Terrain3DData::get_region_id(const Vector2i &p_region_loc) const {
 	int map_index = get_region_map_index(p_region_loc);
 	if (map_index >= 0) {
 		int region_id = _region_map[map_index] - 1; // 0 = no region
-		if (region_id >= 0 && region_id < _region_locations.size()) {
+		if (region_id >= 0 && region_id < int(_layer_locations.size())) {
 			return region_id;
 		}
 	}
@@ -232,12 +370,19 @@ inline int Terrain3DData::get_region_idp(const Vector3 &p_global_position) const
 	return get_region_id(get_region_location(p_global_position));
 }
 
+// Returns any stored region, including those marked for deletion. Null if none or out of bounds.
+// For internal hot paths. The pointer is only valid while the region remains in `_regions`.
+inline Terrain3DRegion *Terrain3DData::get_region_ptr(const Vector2i &p_region_loc) const {
+	int map_index = get_region_map_index(p_region_loc);
+	return (map_index >= 0) ? _region_slots[map_index] : nullptr;
+}
+
 inline Ref<Terrain3DRegion> Terrain3DData::get_region(const Vector2i &p_region_loc) const {
-	return _regions.get(p_region_loc, Ref<Terrain3DRegion>());
+	return Ref<Terrain3DRegion>(get_region_ptr(p_region_loc));
 }
 
 inline Ref<Terrain3DRegion> Terrain3DData::get_regionp(const Vector3 &p_global_position) const {
-	return _regions.get(get_region_location(p_global_position), Ref<Terrain3DRegion>());
+	return Ref<Terrain3DRegion>(get_region_ptr(get_region_location(p_global_position)));
 }
 
 // Inline Map Functions
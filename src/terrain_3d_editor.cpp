@@ -172,11 +172,6 @@ void Terrain3DEditor::_operate_map(const Vector3 &p_global_position, const real_
 	// MAP Operations
 	real_t vertex_spacing = _terrain->get_vertex_spacing();
 
-	// save region count before brush pixel loop. Any regions added will have caused an Array
-	// rebuild at the end of the last _operate() call, but until painting is finished we only
-	// need to track if _added_removed_locations has changed between now and the end of the loop
-	int regions_added_removed = _added_removed_locations.size();
-
 	for (real_t x = 0.f; x < brush_size; x += vertex_spacing) {
 		for (real_t y = 0.f; y < brush_size; y += vertex_spacing) {
 			Vector2 brush_offset = Vector2(x, y) - (Vector2(brush_size, brush_size) / 2.f);
@@ -515,21 +510,17 @@ void Terrain3DEditor::_operate_map(const Vector3 &p_global_position, const real_
 			region->get_map(map_type)->generate_mipmaps();
 		}
 	}
-	// If no added or removed regions, update only changed texture array layers from the edited regions in the rendering server
-	if (_added_removed_locations.size() == regions_added_removed) {
-		data->update_maps(map_type);
-	} else {
-		// If region qty was changed, must fully rebuild the maps
-		data->force_update_maps(map_type);
-	}
+	// Update only changed texture array layers from the edited regions in the rendering server.
+	// Added or removed regions were already placed in or freed from their own layers.
+	data->update_maps(map_type);
 	data->add_edited_area(edited_area);
 
 	if (_tool == HOLES || _tool == HEIGHT || _tool == SCULPT) {
 		_terrain->get_instancer()->update_transforms(edited_area);
 	}
-	// Update Dynamic / Editor collision
-	if (_terrain->get_collision_mode() == Terrain3DCollision::DYNAMIC_EDITOR) {
-		_terrain->get_collision()->update(true);
+	// Update editor collision under the brush
+	if (_terrain->get_collision()->is_editor_mode()) {
+		_terrain->get_collision()->invalidate_area(edited_area);
 	}
 }
 
@@ -597,8 +588,7 @@ void Terrain3DEditor::_apply_undo(const Dictionary &p_data) {
 				continue;
 			}
 			region->sanitize_maps(); // Live data may not have some maps so must be sanitized
-			Dictionary regions = data->get_regions_all();
-			regions[region->get_location()] = region;
+			data->_store_region(region);
 			region->set_modified(true);
 			// Tell update_maps() this region has layers that can be individually updated
 			region->set_edited(true);
@@ -608,6 +598,9 @@ void Terrain3DEditor::_apply_undo(const Dictionary &p_data) {
 	if (p_data.has("edited_area")) {
 		LOG(DEBUG, "Edited area: ", p_data["edited_area"]);
 		data->add_edited_area(p_data["edited_area"]);
+		if (_terrain->get_collision()->is_editor_mode()) {
+			_terrain->get_collision()->invalidate_area(p_data["edited_area"]);
+		}
 	}
 
 	if (p_data.has("added_regions")) {
@@ -640,12 +633,8 @@ void Terrain3DEditor::_apply_undo(const Dictionary &p_data) {
 		Array locations = data->get_region_locations();
 		LOG(DEBUG, "Locations(", locations.size(), "): ", locations);
 	}
-	// If this undo set modifies the region qty, we must rebuild the arrays. Otherwise we can update individual layers
-	if (p_data.has("added_regions") || p_data.has("removed_regions")) {
-		data->force_update_maps();
-	} else {
-		data->update_maps();
-	}
+	// Regions added or removed by this undo set only change their own layers, so no full rebuild is needed
+	data->update_maps();
 	// After TextureArray updates clear edited regions flag.
 	if (p_data.has("edited_regions")) {
 		TypedArray<Terrain3DRegion> undo_regions = p_data["edited_regions"];
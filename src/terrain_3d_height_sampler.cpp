@@ -0,0 +1,582 @@
+// Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
+
+#include "logger.h"
+#include "terrain_3d_height_sampler.h"
+
+///////////////////////////
+// Private Functions
+///////////////////////////
+
+Terrain3DHeightSampler::GridWalk::GridWalk(const Vector2 &p_origin, const Vector2 &p_direction, const real_t p_t, const int p_cell_size) {
+	Vector2 pos = p_origin + p_direction * p_t;
+	cell = Vector2i((pos / real_t(p_cell_size)).floor());
+	for (int axis = 0; axis < 2; axis++) {
+		if (p_direction[axis] > 0.f) {
+			step[axis] = 1;
+			t_next[axis] = (real_t((cell[axis] + 1) * p_cell_size) - p_origin[axis]) / p_direction[axis];
+			t_delta[axis] = real_t(p_cell_size) / p_direction[axis];
+		} else if (p_direction[axis] < 0.f) {
+			step[axis] = -1;
+			t_next[axis] = (real_t(cell[axis] * p_cell_size) - p_origin[axis]) / p_direction[axis];
+			t_delta[axis] = -real_t(p_cell_size) / p_direction[axis];
+		} else {
+			step[axis] = 0;
+			t_next[axis] = FLT_MAX;
+			t_delta[axis] = FLT_MAX;
+		}
+	}
+}
+
+void Terrain3DHeightSampler::GridWalk::advance() {
+	if (t_next.x < t_next.y) {
+		cell.x += step.x;
+		t_next.x += t_delta.x;
+	} else {
+		cell.y += step.y;
+		t_next.y += t_delta.y;
+	}
+}
+
+// Pins the region's height and control buffers. Called by Terrain3DData on the main thread.
+void Terrain3DHeightSampler::_add_region(Terrain3DRegion *p_region) {
+	if (p_region == nullptr || p_region->is_deleted()) {
+		return;
+	}
+	Vector2i loc = p_region->get_location() + V2I(REGION_MAP_SIZE / 2);
+	if ((uint32_t(loc.x | loc.y) & uint32_t(~0x1F)) > 0) {
+		LOG(ERROR, "Region location ", p_region->get_location(), " out of bounds");
+		return;
+	}
+	Ref<Image> height_map = p_region->get_height_map();
+	Ref<Image> control_map = p_region->get_control_map();
+	if (height_map.is_null() || control_map.is_null()) {
+		LOG(ERROR, "Region ", p_region->get_location(), " is missing maps");
+		return;
+	}
+	RegionMaps maps;
+	// Shares the Image buffers. Later writes to the Images copy them, leaving these untouched.
+	maps.height_data = height_map->get_data();
+	maps.control_data = control_map->get_data();
+	int map_bytes = _region_size * _region_size * sizeof(float);
+	if (maps.height_data.size() < map_bytes || maps.control_data.size() < map_bytes) {
+		LOG(ERROR, "Region ", p_region->get_location(), " maps don't match region size ", _region_size);
+		return;
+	}
+	maps.heights = reinterpret_cast<const float *>(maps.height_data.ptr());
+	maps.controls = reinterpret_cast<const uint32_t *>(maps.control_data.ptr());
+
+	// Tile max heights let raycasts skip over terrain below the ray
+	int tiles = _region_size / Terrain3DRegion::HEIGHT_TILE_SIZE;
+	maps.tile_data = p_region->get_height_tiles();
+	Vector2 range;
+	bool hole = false;
+	if (maps.tile_data.size() == tiles * tiles && p_region->query_height_pyramid(Rect2i(V2I_ZERO, V2I(_region_size)), range, hole)) {
+		maps.tile_maxes = maps.tile_data.ptr();
+	} else {
+		LOG(WARN, "Region ", p_region->get_location(), " has no height tiles. Raycasts will test every cell");
+		range = p_region->get_height_range();
+	}
+	_height_range.x = MIN(_height_range.x, range.x);
+	_height_range.y = MAX(_height_range.y, range.y);
+	_region_map[loc.y * REGION_MAP_SIZE + loc.x] = _maps.size();
+	_maps.push_back(maps);
+}
+
+// Returns an upper bound of the surface over the cells of a tile, whose vertices reach into the
+// tiles on the +X and +Z sides. Returns -FLT_MAX if the tile has no region, or FLT_MAX if unknown.
+real_t Terrain3DHeightSampler::_get_tile_bound(const Vector2i &p_tile) const {
+	const int tile_size = Terrain3DRegion::HEIGHT_TILE_SIZE;
+	const int tiles = _region_size / tile_size;
+	real_t bound = -FLT_MAX;
+	for (int i = 0; i < 4; i++) {
+		int index = 0;
+		const RegionMaps *maps = _get_maps((p_tile + Vector2i(i & 1, i >> 1)) * tile_size, index);
+		if (maps == nullptr) {
+			if (i == 0) {
+				return -FLT_MAX;
+			}
+			continue; // Vertices out of regions are NAN, so those cells can't be hit
+		}
+		if (maps->tile_maxes == nullptr) {
+			return FLT_MAX;
+		}
+		int x = (index % _region_size) / tile_size;
+		int y = (index / _region_size) / tile_size;
+		bound = MAX(bound, maps->tile_maxes[y * tiles + x]);
+	}
+	return bound;
+}
+
+// Tests the cells within a tile crossed by the ray between p_t_start and p_t_end, nearest first
+bool Terrain3DHeightSampler::_intersect_tile(const Vector3 &p_origin, const Vector3 &p_direction, const real_t p_t_start,
+		const real_t p_t_end, real_t &r_t) const {
+	Vector2 origin = Vector2(p_origin.x, p_origin.z);
+	Vector2 direction = Vector2(p_direction.x, p_direction.z);
+	GridWalk walk(origin, direction, p_t_start, 1);
+	real_t t = p_t_start;
+	while (true) {
+		real_t t_exit = MIN(walk.get_exit(), p_t_end);
+		if (_intersect_cell(p_origin, p_direction, walk.cell, t, t_exit, r_t)) {
+			return true;
+		}
+		if (t_exit >= p_t_end) {
+			return false;
+		}
+		t = t_exit;
+		walk.advance();
+	}
+}
+
+// Tests the ray between p_t_start and p_t_end against the two triangles of a cell. The cell is
+// split along the diagonal from (x, z) to (x+1, z+1), as the mesh and Terrain3D::bake_mesh().
+bool Terrain3DHeightSampler::_intersect_cell(const Vector3 &p_origin, const Vector3 &p_direction, const Vector2i &p_cell,
+		const real_t p_t_start, const real_t p_t_end, real_t &r_t) const {
+	int index = 0;
+	const RegionMaps *maps = _get_maps(p_cell, index);
+	if (maps == nullptr || ::is_hole(maps->controls[index])) {
+		return false;
+	}
+	real_t h00 = maps->heights[index];
+	real_t h10 = _get_vertex_height(p_cell + Vector2i(1, 0));
+	real_t h01 = _get_vertex_height(p_cell + Vector2i(0, 1));
+	real_t h11 = _get_vertex_height(p_cell + Vector2i(1, 1));
+	if (std::isnan(h00) || std::isnan(h10) || std::isnan(h01) || std::isnan(h11)) {
+		return false;
+	}
+
+	// Height of the ray above the triangle containing the ray at p_t_mid, at p_t
+	auto height_above = [&](const real_t p_t, const real_t p_t_mid) -> real_t {
+		real_t u = p_origin.x + p_direction.x * p_t - real_t(p_cell.x);
+		real_t v = p_origin.z + p_direction.z * p_t - real_t(p_cell.y);
+		real_t u_mid = p_origin.x + p_direction.x * p_t_mid - real_t(p_cell.x);
+		real_t v_mid = p_origin.z + p_direction.z * p_t_mid - real_t(p_cell.y);
+		real_t height = 0.f;
+		if (u_mid >= v_mid) {
+			height = h00 + u * (h10 - h00) + v * (h11 - h10);
+		} else {
+			height = h00 + v * (h01 - h00) + u * (h11 - h01);
+		}
+		return p_origin.y + p_direction.y * p_t - height;
+	};
+
+	// Split the segment where it crosses the diagonal, so each part lies over one triangle
+	real_t t_split = p_t_end;
+	real_t du = p_direction.x - p_direction.z;
+	if (du != 0.f) {
+		real_t t = ((real_t(p_cell.x) - p_origin.x) - (real_t(p_cell.y) - p_origin.z)) / du;
+		if (t > p_t_start && t < p_t_end) {
+			t_split = t;
+		}
+	}
+	real_t bounds[3] = { p_t_start, t_split, p_t_end };
+	for (int i = 0; i < 2; i++) {
+		real_t a = bounds[i];
+		real_t b = bounds[i + 1];
+		if (i == 1 && a >= b) {
+			break;
+		}
+		real_t mid = (a + b) * 0.5f;
+		real_t above_a = height_above(a, mid);
+		real_t above_b = height_above(b, mid);
+		if (above_a <= 0.f) {
+			r_t = a;
+			return true;
+		}
+		if (above_b <= 0.f) {
+			r_t = a + (b - a) * above_a / (above_a - above_b);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Returns the point on triangle abc nearest to p_point. From Real-Time Collision Detection, 5.1.5
+Vector3 Terrain3DHeightSampler::_closest_point_on_triangle(const Vector3 &p_point, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) {
+	Vector3 ab = p_b - p_a;
+	Vector3 ac = p_c - p_a;
+	Vector3 ap = p_point - p_a;
+	real_t d1 = ab.dot(ap);
+	real_t d2 = ac.dot(ap);
+	if (d1 <= 0.f && d2 <= 0.f) {
+		return p_a;
+	}
+	Vector3 bp = p_point - p_b;
+	real_t d3 = ab.dot(bp);
+	real_t d4 = ac.dot(bp);
+	if (d3 >= 0.f && d4 <= d3) {
+		return p_b;
+	}
+	real_t vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) {
+		return p_a + ab * (d1 / (d1 - d3));
+	}
+	Vector3 cp = p_point - p_c;
+	real_t d5 = ab.dot(cp);
+	real_t d6 = ac.dot(cp);
+	if (d6 >= 0.f && d5 <= d6) {
+		return p_c;
+	}
+	real_t vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) {
+		return p_a + ac * (d2 / (d2 - d6));
+	}
+	real_t va = d3 * d6 - d5 * d4;
+	if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) {
+		return p_b + (p_c - p_b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	}
+	real_t denom = 1.f / (va + vb + vc);
+	return p_a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Returns true if the sphere touches or is below the surface, triangulated as the mesh. Tests the
+// triangles of every cell under the sphere's footprint, except holes and cells below it.
+bool Terrain3DHeightSampler::_sphere_overlaps(const Vector3 &p_center, const real_t p_radius) const {
+	if (p_center.y - p_radius > _height_range.y) {
+		return false;
+	}
+	if (is_below_surface(p_center)) {
+		return true;
+	}
+	Vector2i start = Vector2i(((Vector2(p_center.x, p_center.z) - V2(p_radius)) / _vertex_spacing).floor());
+	Vector2i end = Vector2i(((Vector2(p_center.x, p_center.z) + V2(p_radius)) / _vertex_spacing).floor());
+	real_t radius_sq = p_radius * p_radius;
+	real_t bottom = p_center.y - p_radius;
+	for (int z = start.y; z <= end.y; z++) {
+		for (int x = start.x; x <= end.x; x++) {
+			Vector2i cell = Vector2i(x, z);
+			int index = 0;
+			const RegionMaps *maps = _get_maps(cell, index);
+			if (maps == nullptr || ::is_hole(maps->controls[index])) {
+				continue;
+			}
+			real_t h00 = maps->heights[index];
+			real_t h10 = _get_vertex_height(cell + Vector2i(1, 0));
+			real_t h01 = _get_vertex_height(cell + Vector2i(0, 1));
+			real_t h11 = _get_vertex_height(cell + Vector2i(1, 1));
+			if (std::isnan(h00) || std::isnan(h10) || std::isnan(h01) || std::isnan(h11)) {
+				continue;
+			}
+			if (bottom > MAX(MAX(h00, h10), MAX(h01, h11))) {
+				continue;
+			}
+			real_t x0 = real_t(x) * _vertex_spacing;
+			real_t z0 = real_t(z) * _vertex_spacing;
+			real_t x1 = x0 + _vertex_spacing;
+			real_t z1 = z0 + _vertex_spacing;
+			Vector3 v00 = Vector3(x0, h00, z0);
+			Vector3 v11 = Vector3(x1, h11, z1);
+			// Split along the diagonal from (x, z) to (x+1, z+1), as _intersect_cell()
+			if (p_center.distance_squared_to(_closest_point_on_triangle(p_center, v00, Vector3(x1, h10, z0), v11)) <= radius_sq ||
+					p_center.distance_squared_to(_closest_point_on_triangle(p_center, v00, v11, Vector3(x0, h01, z1))) <= radius_sq) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+///////////////////////////
+// Public Functions
+///////////////////////////
+
+bool Terrain3DHeightSampler::has_regionp(const Vector3 &p_global_position) const {
+	int index = 0;
+	Vector2i pixel = Vector2i((Vector2(p_global_position.x, p_global_position.z) / _vertex_spacing).floor());
+	return _get_maps(pixel, index) != nullptr;
+}
+
+// Returns false outside of regions, as Terrain3DData::get_control_hole()
+bool Terrain3DHeightSampler::is_hole(const Vector3 &p_global_position) const {
+	int index = 0;
+	Vector2i pixel = Vector2i((Vector2(p_global_position.x, p_global_position.z) / _vertex_spacing).floor());
+	const RegionMaps *maps = _get_maps(pixel, index);
+	return (maps == nullptr) ? false : ::is_hole(maps->controls[index]);
+}
+
+// Matches Terrain3DData::get_height()
+real_t Terrain3DHeightSampler::get_height(const Vector3 &p_global_position) const {
+	Vector2 pos = Vector2(p_global_position.x, p_global_position.z) / _vertex_spacing;
+	Vector2 pos00 = pos.floor();
+	Vector2i pixel = Vector2i(pos00);
+	int index = 0;
+	const RegionMaps *maps = _get_maps(pixel, index);
+	if (maps == nullptr || ::is_hole(maps->controls[index])) {
+		return NAN;
+	}
+	// If requested position is close to a vertex, return its height
+	Vector2 pos_round = pos.round();
+	if ((pos - pos_round).length() * _vertex_spacing < 0.01f) {
+		return _get_vertex_height(Vector2i(pos_round));
+	}
+	// Otherwise, bilinearly interpolate 4 surrounding vertices
+	real_t ht00 = maps->heights[index];
+	real_t ht01 = _get_vertex_height(pixel + Vector2i(0, 1));
+	real_t ht10 = _get_vertex_height(pixel + Vector2i(1, 0));
+	real_t ht11 = _get_vertex_height(pixel + Vector2i(1, 1));
+	return bilerp(ht00, ht01, ht10, ht11, pos00, pos00 + Vector2(1.f, 1.f), pos);
+}
+
+// Matches Terrain3DData::get_normal()
+Vector3 Terrain3DHeightSampler::get_normal(const Vector3 &p_global_position) const {
+	real_t height = get_height(p_global_position);
+	if (std::isnan(height)) {
+		return Vector3(NAN, NAN, NAN);
+	}
+	real_t u = height - get_height(p_global_position + Vector3(_vertex_spacing, 0.f, 0.f));
+	real_t v = height - get_height(p_global_position + Vector3(0.f, 0.f, _vertex_spacing));
+	Vector3 normal = Vector3(u, _vertex_spacing, v);
+	normal.normalize();
+	return normal;
+}
+
+PackedFloat32Array Terrain3DHeightSampler::get_heights(const PackedVector3Array &p_global_positions) const {
+	PackedFloat32Array heights;
+	int count = p_global_positions.size();
+	heights.resize(count);
+	if (count == 0) {
+		return heights;
+	}
+	const Vector3 *positions = p_global_positions.ptr();
+	float *out = heights.ptrw();
+	for (int i = 0; i < count; i++) {
+		out[i] = get_height(positions[i]);
+	}
+	return heights;
+}
+
+/**
+ * Returns the nearest point where the ray hits the terrain surface, triangulated as the mesh, or
+ * V3_MAX on a miss. Holes and areas without regions are not hit. A ray starting below the surface
+ * returns its origin. The ray is walked through the height tiles of each region, skipping tiles
+ * entirely below it, and the cells of the remaining tiles are tested exactly.
+ */
+Vector3 Terrain3DHeightSampler::get_ray_intersection(const Vector3 &p_origin, const Vector3 &p_direction) const {
+	if (_maps.empty() || p_direction.is_zero_approx()) {
+		return V3_MAX;
+	}
+	real_t height = get_height(p_origin);
+	if (!std::isnan(height) && p_origin.y <= height) {
+		return p_origin;
+	}
+
+	// Work in descaled space, where vertices are 1 apart. Distances along the ray are unchanged.
+	Vector3 origin = Vector3(p_origin.x / _vertex_spacing, p_origin.y, p_origin.z / _vertex_spacing);
+	Vector3 direction = Vector3(p_direction.x / _vertex_spacing, p_direction.y, p_direction.z / _vertex_spacing);
+
+	// Clip the ray to the region map and the height range of all regions, padded for precision
+	real_t half = real_t(REGION_MAP_SIZE / 2 * _region_size);
+	Vector3 low = Vector3(-half, _height_range.x - 1.f, -half);
+	Vector3 high = Vector3(half, _height_range.y + 1.f, half);
+	real_t t_start = 0.f;
+	real_t t_end = FLT_MAX;
+	for (int axis = 0; axis < 3; axis++) {
+		if (direction[axis] == 0.f) {
+			if (origin[axis] < low[axis] || origin[axis] > high[axis]) {
+				return V3_MAX;
+			}
+			continue;
+		}
+		real_t t0 = (low[axis] - origin[axis]) / direction[axis];
+		real_t t1 = (high[axis] - origin[axis]) / direction[axis];
+		t_start = MAX(t_start, MIN(t0, t1));
+		t_end = MIN(t_end, MAX(t0, t1));
+	}
+	if (t_start > t_end) {
+		return V3_MAX;
+	}
+
+	GridWalk walk(Vector2(origin.x, origin.z), Vector2(direction.x, direction.z), t_start, Terrain3DRegion::HEIGHT_TILE_SIZE);
+	real_t t = t_start;
+	while (true) {
+		real_t t_exit = MIN(walk.get_exit(), t_end);
+		real_t ray_low = origin.y + direction.y * ((direction.y < 0.f) ? t_exit : t);
+		real_t hit = 0.f;
+		if (ray_low <= _get_tile_bound(walk.cell) && _intersect_tile(origin, direction, t, t_exit, hit)) {
+			return p_origin + p_direction * hit;
+		}
+		if (t_exit >= t_end) {
+			return V3_MAX;
+		}
+		t = t_exit;
+		walk.advance();
+	}
+}
+
+// Casts each ray as get_ray_intersection(). The arrays must be the same size.
+PackedVector3Array Terrain3DHeightSampler::get_ray_intersections(const PackedVector3Array &p_origins, const PackedVector3Array &p_directions) const {
+	PackedVector3Array points;
+	int count = p_origins.size();
+	if (count != p_directions.size()) {
+		LOG(ERROR, "Origins size ", count, " doesn't match directions size ", p_directions.size());
+		return points;
+	}
+	points.resize(count);
+	if (count == 0) {
+		return points;
+	}
+	const Vector3 *origins = p_origins.ptr();
+	const Vector3 *directions = p_directions.ptr();
+	Vector3 *out = points.ptrw();
+	for (int i = 0; i < count; i++) {
+		out[i] = get_ray_intersection(origins[i], directions[i]);
+	}
+	return points;
+}
+
+// Returns true if the position is below the surface height. Holes and areas outside of regions
+// have no surface, so return false.
+bool Terrain3DHeightSampler::is_below_surface(const Vector3 &p_global_position) const {
+	real_t height = get_height(p_global_position);
+	return !std::isnan(height) && p_global_position.y < height;
+}
+
+// Returns 1 for each position below the surface, 0 otherwise, in the same order
+PackedByteArray Terrain3DHeightSampler::get_points_below_surface(const PackedVector3Array &p_global_positions) const {
+	PackedByteArray flags;
+	int count = p_global_positions.size();
+	flags.resize(count);
+	if (count == 0) {
+		return flags;
+	}
+	const Vector3 *positions = p_global_positions.ptr();
+	uint8_t *out = flags.ptrw();
+	for (int i = 0; i < count; i++) {
+		out[i] = is_below_surface(positions[i]) ? 1 : 0;
+	}
+	return flags;
+}
+
+/**
+ * Moves a sphere from p_origin by p_motion and returns its center where it first touches the
+ * surface, or V3_MAX if it doesn't within p_motion. A sphere that starts touching returns its
+ * origin. The center is walked through the height tiles, and only where the sphere's bottom reaches
+ * the tiles under its footprint is the motion stepped at most half the radius or half a vertex at a
+ * time. The contact is then refined by bisection, so the result is within a few millimeters of exact.
+ */
+Vector3 Terrain3DHeightSampler::get_sphere_sweep(const Vector3 &p_origin, const Vector3 &p_motion, const real_t p_radius) const {
+	if (_maps.empty()) {
+		return V3_MAX;
+	}
+	if (p_radius <= 0.f) {
+		LOG(ERROR, "Radius must be greater than 0: ", p_radius);
+		return V3_MAX;
+	}
+	if (_sphere_overlaps(p_origin, p_radius)) {
+		return p_origin;
+	}
+	real_t length = p_motion.length();
+	if (length <= 0.f) {
+		return V3_MAX;
+	}
+
+	// Work in descaled space, as get_ray_intersection(). The motion is traveled from t = 0 to 1.
+	Vector3 origin = Vector3(p_origin.x / _vertex_spacing, p_origin.y, p_origin.z / _vertex_spacing);
+	Vector3 motion = Vector3(p_motion.x / _vertex_spacing, p_motion.y, p_motion.z / _vertex_spacing);
+	real_t footprint = p_radius / _vertex_spacing;
+
+	// Clip the motion to where the sphere reaches the region map and isn't above all regions
+	real_t half = real_t(REGION_MAP_SIZE / 2 * _region_size) + footprint;
+	Vector3 low = Vector3(-half, -FLT_MAX, -half);
+	Vector3 high = Vector3(half, _height_range.y + p_radius, half);
+	real_t t = 0.f;
+	real_t t_end = 1.f;
+	for (int axis = 0; axis < 3; axis++) {
+		if (motion[axis] == 0.f) {
+			if (origin[axis] < low[axis] || origin[axis] > high[axis]) {
+				return V3_MAX;
+			}
+			continue;
+		}
+		real_t t0 = (low[axis] - origin[axis]) / motion[axis];
+		real_t t1 = (high[axis] - origin[axis]) / motion[axis];
+		t = MAX(t, MIN(t0, t1));
+		t_end = MIN(t_end, MAX(t0, t1));
+	}
+	if (t > t_end) {
+		return V3_MAX;
+	}
+
+	// The footprint of a sphere centered in a tile reaches this many tiles around it
+	const int tile_size = Terrain3DRegion::HEIGHT_TILE_SIZE;
+	int reach = int(Math::ceil(footprint / real_t(tile_size)));
+	real_t t_step = MIN(p_radius, _vertex_spacing) * 0.5f / length;
+	GridWalk walk(Vector2(origin.x, origin.z), Vector2(motion.x, motion.z), t, tile_size);
+	while (true) {
+		real_t t_exit = MIN(walk.get_exit(), t_end);
+		real_t bottom = origin.y + motion.y * ((motion.y < 0.f) ? t_exit : t) - p_radius;
+		real_t bound = -FLT_MAX;
+		for (int z = -reach; z <= reach && bound < bottom; z++) {
+			for (int x = -reach; x <= reach && bound < bottom; x++) {
+				bound = MAX(bound, _get_tile_bound(walk.cell + Vector2i(x, z)));
+			}
+		}
+		// Step through the tile only if the sphere can reach the surface around it
+		while (bottom <= bound && t < t_exit) {
+			real_t t_next = MIN(t + t_step, t_exit);
+			if (_sphere_overlaps(p_origin + p_motion * t_next, p_radius)) {
+				// Bisect between the last clear position and the touching one
+				real_t t_low = t;
+				real_t t_high = t_next;
+				for (int i = 0; i < 12; i++) {
+					real_t t_mid = (t_low + t_high) * 0.5f;
+					if (_sphere_overlaps(p_origin + p_motion * t_mid, p_radius)) {
+						t_high = t_mid;
+					} else {
+						t_low = t_mid;
+					}
+				}
+				return p_origin + p_motion * t_low;
+			}
+			t = t_next;
+		}
+		if (t_exit >= t_end) {
+			return V3_MAX;
+		}
+		t = t_exit;
+		walk.advance();
+	}
+}
+
+// Sweeps a sphere from each origin by the matching motion, as get_sphere_sweep(). The arrays must be
+// the same size.
+PackedVector3Array Terrain3DHeightSampler::get_sphere_sweeps(const PackedVector3Array &p_origins, const PackedVector3Array &p_motions, const real_t p_radius) const {
+	PackedVector3Array points;
+	int count = p_origins.size();
+	if (count != p_motions.size()) {
+		LOG(ERROR, "Origins size ", count, " doesn't match motions size ", p_motions.size());
+		return points;
+	}
+	points.resize(count);
+	if (count == 0) {
+		return points;
+	}
+	const Vector3 *origins = p_origins.ptr();
+	const Vector3 *motions = p_motions.ptr();
+	Vector3 *out = points.ptrw();
+	for (int i = 0; i < count; i++) {
+		out[i] = get_sphere_sweep(origins[i], motions[i], p_radius);
+	}
+	return points;
+}
+
+///////////////////////////
+// Protected Functions
+///////////////////////////
+
+void Terrain3DHeightSampler::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_region_size"), &Terrain3DHeightSampler::get_region_size);
+	ClassDB::bind_method(D_METHOD("get_vertex_spacing"), &Terrain3DHeightSampler::get_vertex_spacing);
+	ClassDB::bind_method(D_METHOD("get_region_count"), &Terrain3DHeightSampler::get_region_count);
+
+	ClassDB::bind_method(D_METHOD("has_regionp", "global_position"), &Terrain3DHeightSampler::has_regionp);
+	ClassDB::bind_method(D_METHOD("is_hole", "global_position"), &Terrain3DHeightSampler::is_hole);
+	ClassDB::bind_method(D_METHOD("get_height", "global_position"), &Terrain3DHeightSampler::get_height);
+	ClassDB::bind_method(D_METHOD("get_normal", "global_position"), &Terrain3DHeightSampler::get_normal);
+	ClassDB::bind_method(D_METHOD("get_heights", "global_positions"), &Terrain3DHeightSampler::get_heights);
+	ClassDB::bind_method(D_METHOD("get_ray_intersection", "origin", "direction"), &Terrain3DHeightSampler::get_ray_intersection);
+	ClassDB::bind_method(D_METHOD("get_ray_intersections", "origins", "directions"), &Terrain3DHeightSampler::get_ray_intersections);
+	ClassDB::bind_method(D_METHOD("is_below_surface", "global_position"), &Terrain3DHeightSampler::is_below_surface);
+	ClassDB::bind_method(D_METHOD("get_points_below_surface", "global_positions"), &Terrain3DHeightSampler::get_points_below_surface);
+	ClassDB::bind_method(D_METHOD("get_sphere_sweep", "origin", "motion", "radius"), &Terrain3DHeightSampler::get_sphere_sweep);
+	ClassDB::bind_method(D_METHOD("get_sphere_sweeps", "origins", "motions", "radius"), &Terrain3DHeightSampler::get_sphere_sweeps);
+}
@@ -0,0 +1,121 @@
+// Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
+
+#ifndef TERRAIN3D_HEIGHT_SAMPLER_CLASS_H
+#define TERRAIN3D_HEIGHT_SAMPLER_CLASS_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <vector>
+
+#include "constants.h"
+#include "terrain_3d_region.h"
+
+class Terrain3DData;
+
+using namespace godot;
+
+// A read-only snapshot of the height and control maps of all active regions, taken from
+// Terrain3DData::get_height_sampler(). The map buffers are shared copy-on-write with the live
+// Images, so taking a snapshot doesn't copy map data. A write to a region's map only pays for a
+// copy while a snapshot referencing that buffer is alive.
+// All queries are lock-free and safe to call from any thread.
+class Terrain3DHeightSampler : public RefCounted {
+	GDCLASS(Terrain3DHeightSampler, RefCounted);
+	CLASS_NAME();
+	friend Terrain3DData;
+
+public: // Constants
+	static inline const int REGION_MAP_SIZE = 32; // Matches Terrain3DData::REGION_MAP_SIZE
+
+private:
+	struct RegionMaps {
+		PackedByteArray height_data;
+		PackedByteArray control_data;
+		PackedFloat32Array tile_data;
+		const float *heights = nullptr;
+		const uint32_t *controls = nullptr;
+		const float *tile_maxes = nullptr; // Terrain3DRegion::get_height_tiles(), or nullptr
+	};
+
+	// Steps through the cells of a grid crossed by a ray in descaled space, in order
+	struct GridWalk {
+		Vector2i cell;
+		Vector2i step;
+		Vector2 t_next; // Ray distance to the next cell boundary on each axis
+		Vector2 t_delta; // Ray distance between cell boundaries on each axis
+
+		GridWalk(const Vector2 &p_origin, const Vector2 &p_direction, const real_t p_t, const int p_cell_size);
+		real_t get_exit() const { return MIN(t_next.x, t_next.y); }
+		void advance();
+	};
+
+	int _region_size = 0;
+	real_t _vertex_spacing = 1.f;
+	Vector2 _height_range = Vector2(FLT_MAX, -FLT_MAX); // Of all regions
+	// 32x32 grid with the index into _maps at its location, no region = -1
+	std::array<int32_t, REGION_MAP_SIZE * REGION_MAP_SIZE> _region_map;
+	std::vector<RegionMaps> _maps;
+
+	void _add_region(Terrain3DRegion *p_region);
+	const RegionMaps *_get_maps(const Vector2i &p_pixel, int &r_index) const;
+	real_t _get_vertex_height(const Vector2i &p_pixel) const;
+	real_t _get_tile_bound(const Vector2i &p_tile) const;
+	bool _intersect_tile(const Vector3 &p_origin, const Vector3 &p_direction, const real_t p_t_start,
+			const real_t p_t_end, real_t &r_t) const;
+	bool _intersect_cell(const Vector3 &p_origin, const Vector3 &p_direction, const Vector2i &p_cell,
+			const real_t p_t_start, const real_t p_t_end, real_t &r_t) const;
+	static Vector3 _closest_point_on_triangle(const Vector3 &p_point, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c);
+	bool _sphere_overlaps(const Vector3 &p_center, const real_t p_radius) const;
+
+public:
+	Terrain3DHeightSampler() { _region_map.fill(-1); }
+	~Terrain3DHeightSampler() {}
+
+	int get_region_size() const { return _region_size; }
+	real_t get_vertex_spacing() const { return _vertex_spacing; }
+	int get_region_count() const { return _maps.size(); }
+
+	bool has_regionp(const Vector3 &p_global_position) const;
+	bool is_hole(const Vector3 &p_global_position) const;
+	real_t get_height(const Vector3 &p_global_position) const;
+	Vector3 get_normal(const Vector3 &p_global_position) const;
+	PackedFloat32Array get_heights(const PackedVector3Array &p_global_positions) const;
+	Vector3 get_ray_intersection(const Vector3 &p_origin, const Vector3 &p_direction) const;
+	PackedVector3Array get_ray_intersections(const PackedVector3Array &p_origins, const PackedVector3Array &p_directions) const;
+	bool is_below_surface(const Vector3 &p_global_position) const;
+	PackedByteArray get_points_below_surface(const PackedVector3Array &p_global_positions) const;
+	Vector3 get_sphere_sweep(const Vector3 &p_origin, const Vector3 &p_motion, const real_t p_radius) const;
+	PackedVector3Array get_sphere_sweeps(const PackedVector3Array &p_origins, const PackedVector3Array &p_motions, const real_t p_radius) const;
+
+protected:
+	static void _bind_methods();
+};
+
+// Inline Functions
+
+// Returns the maps of the region containing the descaled pixel and the pixel's index into them.
+// Returns nullptr if out of bounds or there is no region.
+inline const Terrain3DHeightSampler::RegionMaps *Terrain3DHeightSampler::_get_maps(const Vector2i &p_pixel, int &r_index) const {
+	if (_region_size <= 0) {
+		return nullptr;
+	}
+	Vector2i region_loc = V2I_DIVIDE_FLOOR(p_pixel, _region_size);
+	Vector2i loc = region_loc + V2I(REGION_MAP_SIZE / 2);
+	if ((uint32_t(loc.x | loc.y) & uint32_t(~0x1F)) > 0) {
+		return nullptr;
+	}
+	int map_id = _region_map[loc.y * REGION_MAP_SIZE + loc.x];
+	if (map_id < 0) {
+		return nullptr;
+	}
+	Vector2i img_pos = p_pixel - region_loc * _region_size;
+	r_index = img_pos.y * _region_size + img_pos.x;
+	return &_maps[map_id];
+}
+
+inline real_t Terrain3DHeightSampler::_get_vertex_height(const Vector2i &p_pixel) const {
+	int index = 0;
+	const RegionMaps *maps = _get_maps(p_pixel, index);
+	return (maps == nullptr) ? NAN : maps->heights[index];
+}
+
+#endif // TERRAIN3D_HEIGHT_SAMPLER_CLASS_H
@@ -62,15 +62,14 @@ void Terrain3DInstancer::_update_mmis(const Vector2i &p_region_loc, const int p_
 			for (int c = 0; c < cell_locations.size(); c++) {
 				// Get instances
 				Vector2i cell = cell_locations[c];
-				Array triple = cell_inst_dict[cell];
-				if (triple.size() < 3) {
-					LOG(WARN, "Triple is empty");
+				Array pair = cell_inst_dict[cell];
+				if (pair.size() < 2) {
+					LOG(WARN, "Pair is empty");
 					continue;
 				}
-				TypedArray<Transform3D> xforms = triple[0];
-				PackedColorArray colors = triple[1];
-				bool modified = triple[2];
-				if (xforms.size() == 0) {
+				PackedFloat32Array buffer = pair[0];
+				bool modified = pair[1];
+				if (buffer.size() == 0) {
 					LOG(WARN, "Empty cell in region ", region_loc, " cell ", cell);
 					continue;
 				}
@@ -120,9 +119,15 @@ void Terrain3DInstancer::_update_mmis(const Vector2i &p_region_loc, const int p_
 					continue;
 				}
 
-				// Create MM and assign to MMI
+				// Refill the MM in place, keeping it and the MMI's RS instance. Create one if new or
+				// the mesh asset changed its mesh.
 				mmi = cell_mmi_dict[cell];
-				mmi->set_multimesh(_create_multimesh(mesh_id, xforms, colors));
+				Ref<MultiMesh> mm = mmi->get_multimesh();
+				if (mm.is_valid() && mm->get_mesh() == mesh) {
+					_fill_multimesh(mm, buffer);
+				} else {
+					mmi->set_multimesh(_create_multimesh(mesh_id, buffer));
+				}
 
 				// Reposition the MMIs to their region location
 				Transform3D t = Transform3D();
@@ -133,7 +138,7 @@ void Terrain3DInstancer::_update_mmis(const Vector2i &p_region_loc, const int p_
 				mmi->set_global_transform(t);
 
 				// Set the cell modified state to false
-				triple[2] = false;
+				pair[1] = false;
 			}
 		}
 	}
@@ -166,20 +171,21 @@ void Terrain3DInstancer::_update_vertex_spacing(const real_t p_vertex_spacing) {
 			for (int c = 0; c < cell_locations.size(); c++) {
 				// Get instances
 				Vector2i cell = cell_locations[c];
-				Array triple = cell_inst_dict[cell];
-				TypedArray<Transform3D> xforms = triple[0];
+				Array pair = cell_inst_dict[cell];
+				PackedFloat32Array buffer = pair[0];
 				// Descale, then Scale to the new value
-				for (int i = 0; i < xforms.size(); i++) {
-					Transform3D t = xforms[i];
+				float *data = buffer.ptrw();
+				for (int i = 0; i < buffer.size(); i += INSTANCE_STRIDE) {
+					Transform3D t = read_transform(data + i);
 					t.origin.x /= old_spacing;
 					t.origin.x *= p_vertex_spacing;
 					t.origin.z /= old_spacing;
 					t.origin.z *= p_vertex_spacing;
-					xforms[i] = t;
+					write_transform(data + i, t);
 				}
-				triple[0] = xforms;
-				triple[2] = true;
-				cell_inst_dict[cell] = triple;
+				pair[0] = buffer;
+				pair[1] = true;
+				cell_inst_dict[cell] = pair;
 			}
 		}
 		// After all transforms are updated, set the new region vertex spacing value
@@ -271,7 +277,8 @@ void Terrain3DInstancer::_backup_region(const Ref<Terrain3DRegion> &p_region) {
 	}
 }
 
-Ref<MultiMesh> Terrain3DInstancer::_create_multimesh(const int p_mesh_id, const TypedArray<Transform3D> &p_xforms, const PackedColorArray &p_colors) const {
+// Creates a MultiMesh filled from a cell buffer with a single upload
+Ref<MultiMesh> Terrain3DInstancer::_create_multimesh(const int p_mesh_id, const PackedFloat32Array &p_buffer) const {
 	Ref<MultiMesh> mm;
 	IS_INIT(mm);
 	Ref<Terrain3DMeshAsset> mesh_asset = _terrain->get_assets()->get_mesh_asset(p_mesh_id);
@@ -284,17 +291,104 @@ Ref<MultiMesh> Terrain3DInstancer::_create_multimesh(const int p_mesh_id, const
 	mm->set_transform_format(MultiMesh::TRANSFORM_3D);
 	mm->set_use_colors(true);
 	mm->set_mesh(mesh);
+	_fill_multimesh(mm, p_buffer);
+	return mm;
+}
 
-	if (p_xforms.size() > 0) {
-		mm->set_instance_count(p_xforms.size());
-		for (int i = 0; i < p_xforms.size(); i++) {
-			mm->set_instance_transform(i, p_xforms[i]);
-			if (i < p_colors.size()) {
-				mm->set_instance_color(i, p_colors[i]);
-			}
+// Uploads a cell buffer to an existing MM. RS storage is only reallocated if the count changed.
+void Terrain3DInstancer::_fill_multimesh(const Ref<MultiMesh> &p_mm, const PackedFloat32Array &p_buffer) const {
+	if (p_buffer.size() % INSTANCE_STRIDE != 0) {
+		LOG(ERROR, "Instance buffer size ", p_buffer.size(), " isn't a multiple of ", INSTANCE_STRIDE);
+		return;
+	}
+	int count = p_buffer.size() / INSTANCE_STRIDE;
+	if (p_mm->get_instance_count() != count) {
+		p_mm->set_instance_count(count);
+	}
+	if (count > 0) {
+		p_mm->set_buffer(p_buffer);
+	}
+}
+
+// Expects instances in global space. Applies the mesh asset height offset, then appends them to
+// the regions they fall in.
+void Terrain3DInstancer::_add_buffer(const int p_mesh_id, const PackedFloat32Array &p_buffer, const bool p_update) {
+	Ref<Terrain3DMeshAsset> mesh_asset = _terrain->get_assets()->get_mesh_asset(p_mesh_id);
+	real_t height_offset = mesh_asset->get_height_offset();
+	Terrain3DData *data = _terrain->get_data();
+	int region_size = _terrain->get_region_size();
+	real_t vertex_spacing = _terrain->get_vertex_spacing();
+
+	// Separate incoming instances by region, localised to region space
+	LOG(INFO, "Separating ", p_buffer.size() / INSTANCE_STRIDE, " instances into regions");
+	std::unordered_map<Vector2i, PackedFloat32Array, Vector2iHash> region_buffers;
+	const float *in = p_buffer.ptr();
+	for (int i = 0; i + INSTANCE_STRIDE <= p_buffer.size(); i += INSTANCE_STRIDE) {
+		Transform3D t = read_transform(in + i);
+		t.origin += t.basis.get_column(1) * height_offset; // Offset along UP axis
+		Vector2i region_loc = data->get_region_location(t.origin);
+		t.origin.x -= region_loc.x * region_size * vertex_spacing;
+		t.origin.z -= region_loc.y * region_size * vertex_spacing;
+		PackedFloat32Array &buffer = region_buffers[region_loc];
+		int size = buffer.size();
+		buffer.resize(size + INSTANCE_STRIDE);
+		float *out = buffer.ptrw() + size;
+		write_transform(out, t);
+		write_color(out, read_color(in + i));
+	}
+
+	for (const std::pair<const Vector2i, PackedFloat32Array> &it : region_buffers) {
+		_append_buffer(data->get_region(it.first), p_mesh_id, it.second, p_update);
+	}
+}
+
+// Appends instances in region space to the cells they fall in, one write per cell
+void Terrain3DInstancer::_append_buffer(const Ref<Terrain3DRegion> &p_region, const int p_mesh_id, const PackedFloat32Array &p_buffer, const bool p_update) {
+	if (p_region.is_null()) {
+		return;
+	}
+	_backup_region(p_region);
+
+	Dictionary cell_locations = p_region->get_instances()[p_mesh_id];
+	int region_size = p_region->get_region_size();
+
+	// Group instances by cell
+	std::unordered_map<Vector2i, std::vector<int>, Vector2iHash> cell_instances;
+	const float *in = p_buffer.ptr();
+	for (int i = 0; i + INSTANCE_STRIDE <= p_buffer.size(); i += INSTANCE_STRIDE) {
+		cell_instances[_get_cell(read_transform(in + i).origin, region_size)].push_back(i);
+	}
+
+	for (const std::pair<const Vector2i, std::vector<int>> &it : cell_instances) {
+		Vector2i cell = it.first;
+		// Get current instance buffer or create if none
+		Array pair = cell_locations[cell];
+		if (pair.size() != 2) {
+			LOG(DEBUG, "No data at ", p_region->get_location(), ":", cell, ". Creating pair");
+			pair.resize(2);
+			pair[0] = PackedFloat32Array();
 		}
+		PackedFloat32Array buffer = pair[0];
+		int size = buffer.size();
+		buffer.resize(size + it.second.size() * INSTANCE_STRIDE);
+		float *out = buffer.ptrw() + size;
+		for (const int index : it.second) {
+			memcpy(out, in + index, INSTANCE_STRIDE * sizeof(float));
+			out += INSTANCE_STRIDE;
+		}
+
+		// Must write back since there are copy constructors somewhere
+		// see godot-cpp#1149
+		pair[0] = buffer;
+		pair[1] = true;
+		cell_locations[cell] = pair;
+	}
+
+	// Write back dictionary. See above comments
+	p_region->get_instances()[p_mesh_id] = cell_locations;
+	if (p_update) {
+		_update_mmis(p_region->get_location(), p_mesh_id);
 	}
-	return mm;
 }
 
 Vector2i Terrain3DInstancer::_get_cell(const Vector3 &p_global_position, const int p_region_size) {
@@ -309,6 +403,20 @@ Vector2i Terrain3DInstancer::_get_cell(const Vector3 &p_global_position, const i
 // Public Functions
 ///////////////////////////
 
+// Converts script facing arrays to the cell buffer layout. Missing colors are white.
+PackedFloat32Array Terrain3DInstancer::pack_instances(const TypedArray<Transform3D> &p_xforms, const PackedColorArray &p_colors) {
+	PackedFloat32Array buffer;
+	int count = p_xforms.size();
+	buffer.resize(count * INSTANCE_STRIDE);
+	float *out = buffer.ptrw();
+	for (int i = 0; i < count; i++) {
+		write_transform(out, p_xforms[i]);
+		write_color(out, (i < p_colors.size()) ? p_colors[i] : COLOR_WHITE);
+		out += INSTANCE_STRIDE;
+	}
+	return buffer;
+}
+
 void Terrain3DInstancer::initialize(Terrain3D *p_terrain) {
 	if (p_terrain) {
 		_terrain = p_terrain;
@@ -410,8 +518,10 @@ void Terrain3DInstancer::add_instances(const Vector3 &p_global_position, const D
 	bool invert = p_params["modifier_alt"];
 	Terrain3DData *data = _terrain->get_data();
 
-	TypedArray<Transform3D> xforms;
-	PackedColorArray colors;
+	PackedFloat32Array buffer;
+	buffer.resize(count * INSTANCE_STRIDE);
+	float *out = buffer.ptrw();
+	int placed = 0;
 	for (int i = 0; i < count; i++) {
 		Transform3D t;
 
@@ -457,7 +567,7 @@ void Terrain3DInstancer::add_instances(const Vector3 &p_global_position, const D
 		real_t t_scale = CLAMP(fixed_scale + random_scale * (2.f * UtilityFunctions::randf() - 1.f), 0.01f, 10.f);
 		t = t.scaled(Vector3(t_scale, t_scale, t_scale));
 
-		// Position. mesh_asset height offset added in add_transforms
+		// Position. mesh_asset height offset added in _add_buffer
 		real_t offset = height_offset + random_height * (2.f * UtilityFunctions::randf() - 1.f);
 		position += t.basis.get_column(1) * offset; // Offset along UP axis
 		t = t.translated(position);
@@ -467,13 +577,15 @@ void Terrain3DInstancer::add_instances(const Vector3 &p_global_position, const D
 		col.set_v(CLAMP(col.get_v() - random_darken * UtilityFunctions::randf(), 0.f, 1.f));
 		col.set_h(fmod(col.get_h() + random_hue * (2.f * UtilityFunctions::randf() - 1.f), 1.f));
 
-		xforms.push_back(t);
-		colors.push_back(col);
+		write_transform(out + placed * INSTANCE_STRIDE, t);
+		write_color(out + placed * INSTANCE_STRIDE, col);
+		placed++;
 	}
 
 	// Append multimesh
-	if (xforms.size() > 0) {
-		add_transforms(mesh_id, xforms, colors);
+	if (placed > 0) {
+		buffer.resize(placed * INSTANCE_STRIDE);
+		_add_buffer(mesh_id, buffer, true);
 	}
 }
 
@@ -570,14 +682,13 @@ void Terrain3DInstancer::remove_instances(const Vector3 &p_global_position, cons
 			real_t mesh_height_offset = mesh_asset->get_height_offset();
 			for (int c = 0; c < cell_queue.size(); c++) {
 				Vector2i cell = cell_queue[c];
-				Array triple = cell_inst_dict[cell];
-				TypedArray<Transform3D> xforms = triple[0];
-				PackedColorArray colors = triple[1];
-				TypedArray<Transform3D> updated_xforms;
-				PackedColorArray updated_colors;
-				// Remove transforms if inside ring radius
-				for (int i = 0; i < xforms.size(); i++) {
-					Transform3D t = xforms[i];
+				Array pair = cell_inst_dict[cell];
+				PackedFloat32Array buffer = pair[0];
+				// Remove instances if inside ring radius, compacting the rest in place
+				float *instances = buffer.ptrw();
+				int kept = 0;
+				for (int i = 0; i < buffer.size(); i += INSTANCE_STRIDE) {
+					Transform3D t = read_transform(instances + i);
 					// Use localised ring center
 					real_t radial_distance = localised_ring_center.distance_to(Vector2(t.origin.x, t.origin.z));
 					Vector3 height_offset = t.basis.get_column(1) * mesh_height_offset;
@@ -586,16 +697,17 @@ void Terrain3DInstancer::remove_instances(const Vector3 &p_global_position, cons
 							data->is_in_slope(t.origin + global_local_offset - height_offset, slope_range, invert)) {
 						_backup_region(region);
 						continue;
-					} else {
-						updated_xforms.push_back(t);
-						updated_colors.push_back(colors[i]);
 					}
+					if (kept != i) {
+						memmove(instances + kept, instances + i, INSTANCE_STRIDE * sizeof(float));
+					}
+					kept += INSTANCE_STRIDE;
 				}
-				if (updated_xforms.size() > 0) {
-					triple[0] = updated_xforms;
-					triple[1] = updated_colors;
-					triple[2] = true;
-					cell_inst_dict[cell] = triple;
+				if (kept > 0) {
+					buffer.resize(kept);
+					pair[0] = buffer;
+					pair[1] = true;
+					cell_inst_dict[cell] = pair;
 				} else {
 					cell_inst_dict.erase(cell);
 					_destroy_mmi_by_cell(region_loc, m, cell);
@@ -610,18 +722,47 @@ void Terrain3DInstancer::remove_instances(const Vector3 &p_global_position, cons
 }
 
 void Terrain3DInstancer::add_multimesh(const int p_mesh_id, const Ref<MultiMesh> &p_multimesh, const Transform3D &p_xform, const bool p_update) {
-	LOG(INFO, "Extracting ", p_multimesh->get_instance_count(), " transforms from multimesh");
-	TypedArray<Transform3D> xforms;
-	PackedColorArray colors;
-	for (int i = 0; i < p_multimesh->get_instance_count(); i++) {
-		xforms.push_back(p_xform * p_multimesh->get_instance_transform(i));
-		Color c = COLOR_WHITE;
-		if (p_multimesh->is_using_colors()) {
-			c = p_multimesh->get_instance_color(i);
+	IS_DATA_INIT_MESG("Instancer isn't initialized.", VOID);
+	if (p_multimesh.is_null()) {
+		LOG(ERROR, "Multimesh is null");
+		return;
+	}
+	if (p_mesh_id < 0 || p_mesh_id >= _terrain->get_assets()->get_mesh_count()) {
+		LOG(ERROR, "Mesh ID out of range: ", p_mesh_id, ", valid: 0 to ", _terrain->get_assets()->get_mesh_count() - 1);
+		return;
+	}
+	int count = p_multimesh->get_instance_count();
+	if (count == 0) {
+		return;
+	}
+	LOG(INFO, "Extracting ", count, " transforms from multimesh");
+	bool use_colors = p_multimesh->is_using_colors();
+	PackedFloat32Array buffer;
+	buffer.resize(count * INSTANCE_STRIDE);
+	float *out = buffer.ptrw();
+	if (p_multimesh->get_transform_format() == MultiMesh::TRANSFORM_3D) {
+		// Read the source buffer directly. Its layout has colors and custom data only if used.
+		PackedFloat32Array source = p_multimesh->get_buffer();
+		int stride = 12 + (use_colors ? 4 : 0) + (p_multimesh->is_using_custom_data() ? 4 : 0);
+		if (source.size() < count * stride) {
+			LOG(ERROR, "Multimesh buffer size ", source.size(), " is too small for ", count, " instances");
+			return;
+		}
+		const float *in = source.ptr();
+		for (int i = 0; i < count; i++) {
+			write_transform(out, p_xform * read_transform(in));
+			write_color(out, use_colors ? read_color(in) : COLOR_WHITE);
+			in += stride;
+			out += INSTANCE_STRIDE;
+		}
+	} else {
+		for (int i = 0; i < count; i++) {
+			write_transform(out, p_xform * p_multimesh->get_instance_transform(i));
+			write_color(out, use_colors ? p_multimesh->get_instance_color(i) : COLOR_WHITE);
+			out += INSTANCE_STRIDE;
 		}
-		colors.push_back(c);
 	}
-	add_transforms(p_mesh_id, xforms, colors, p_update);
+	_add_buffer(p_mesh_id, buffer, p_update);
 }
 
 // Expects transforms in global space
@@ -635,43 +776,7 @@ void Terrain3DInstancer::add_transforms(const int p_mesh_id, const TypedArray<Tr
 		return;
 	}
 
-	Dictionary xforms_dict;
-	Dictionary colors_dict;
-	Ref<Terrain3DMeshAsset> mesh_asset = _terrain->get_assets()->get_mesh_asset(p_mesh_id);
-
-	// Separate incoming transforms/colors by region Dict{ region_loc => Array() }
-	LOG(INFO, "Separating ", p_xforms.size(), " transforms and ", p_colors.size(), " colors into regions");
-	for (int i = 0; i < p_xforms.size(); i++) {
-		// Get adjusted xform/color
-		Transform3D trns = p_xforms[i];
-		trns.origin += trns.basis.get_column(1) * mesh_asset->get_height_offset(); // Offset along UP axis
-		Color col = COLOR_WHITE;
-		if (p_colors.size() > i) {
-			col = p_colors[i];
-		}
-
-		// Store by region offset
-		Vector2i region_loc = _terrain->get_data()->get_region_location(trns.origin);
-		if (!xforms_dict.has(region_loc)) {
-			xforms_dict[region_loc] = TypedArray<Transform3D>();
-			colors_dict[region_loc] = PackedColorArray();
-		}
-		TypedArray<Transform3D> xforms = xforms_dict[region_loc];
-		PackedColorArray colors = colors_dict[region_loc];
-		xforms.push_back(trns);
-		colors.push_back(col);
-		colors_dict[region_loc] = colors; // Note similar bug as godot-cpp#1149 needs this for PCA
-	}
-
-	// Merge incoming transforms with existing transforms
-	Array region_locations = xforms_dict.keys();
-	for (int i = 0; i < region_locations.size(); i++) {
-		Vector2i region_loc = region_locations[i];
-		TypedArray<Transform3D> xforms = xforms_dict[region_loc];
-		PackedColorArray colors = colors_dict[region_loc];
-		//LOG(MESG, "Appending ", xforms.size(), " xforms, ", colors, " colors to region location: ", region_loc);
-		append_location(region_loc, p_mesh_id, xforms, colors, p_update);
-	}
+	_add_buffer(p_mesh_id, pack_instances(p_xforms, p_colors), p_update);
 }
 
 // Appends new global transforms to existing cells, offsetting transforms to region space, scaled by vertex spacing
@@ -685,15 +790,16 @@ void Terrain3DInstancer::append_location(const Vector2i &p_region_loc, const int
 	int region_size = region->get_region_size();
 	real_t vertex_spacing = _terrain->get_vertex_spacing();
 	Vector2 global_local_offset = Vector2(p_region_loc.x * region_size * vertex_spacing, p_region_loc.y * region_size * vertex_spacing);
-	TypedArray<Transform3D> localised_xforms;
-	for (int i = 0; i < p_xforms.size(); i++) {
-		Transform3D t = p_xforms[i];
+	PackedFloat32Array buffer = pack_instances(p_xforms, p_colors);
+	float *data = buffer.ptrw();
+	for (int i = 0; i < buffer.size(); i += INSTANCE_STRIDE) {
 		// Localise the transform to "region space"
+		Transform3D t = read_transform(data + i);
 		t.origin.x -= global_local_offset.x;
 		t.origin.z -= global_local_offset.y;
-		localised_xforms.push_back(t);
+		write_transform(data + i, t);
 	}
-	append_region(region, p_mesh_id, localised_xforms, p_colors, p_update);
+	_append_buffer(region, p_mesh_id, buffer, p_update);
 }
 
 // append_region requires all transforms are in region space, 0 - region_size * vertex_spacing
@@ -708,44 +814,7 @@ void Terrain3DInstancer::append_region(const Ref<Terrain3DRegion> &p_region, con
 		return;
 	}
 
-	_backup_region(p_region);
-
-	Dictionary cell_locations = p_region->get_instances()[p_mesh_id];
-	int region_size = p_region->get_region_size();
-
-	for (int i = 0; i < p_xforms.size(); i++) {
-		Transform3D xform = p_xforms[i];
-		Color col = p_colors[i];
-		Vector2i cell = _get_cell(xform.origin, region_size);
-
-		// Get current instance arrays or create if none
-		Array triple = cell_locations[cell];
-		bool modified = true;
-		if (triple.size() != 3) {
-			LOG(DEBUG, "No data at ", p_region->get_location(), ":", cell, ". Creating triple");
-			triple.resize(3);
-			triple[0] = TypedArray<Transform3D>();
-			triple[1] = PackedColorArray();
-			triple[2] = modified;
-		}
-		TypedArray<Transform3D> xforms = triple[0];
-		PackedColorArray colors = triple[1];
-		xforms.push_back(xform);
-		colors.push_back(col);
-
-		// Must write back since there are copy constructors somewhere
-		// see godot-cpp#1149
-		triple[0] = xforms;
-		triple[1] = colors;
-		triple[2] = modified;
-		cell_locations[cell] = triple;
-	}
-
-	// Write back dictionary. See above comments
-	p_region->get_instances()[p_mesh_id] = cell_locations;
-	if (p_update) {
-		_update_mmis(p_region->get_location(), p_mesh_id);
-	}
+	_append_buffer(p_region, p_mesh_id, pack_instances(p_xforms, p_colors), p_update);
 }
 
 // Review all transforms in one area and adjust their transforms w/ the current height
@@ -828,13 +897,13 @@ void Terrain3DInstancer::update_transforms(const AABB &p_aabb) {
 			real_t mesh_height_offset = mesh_asset->get_height_offset();
 			for (int c = 0; c < cell_queue.size(); c++) {
 				Vector2i cell = cell_queue[c];
-				Array triple = cell_inst_dict[cell];
-				TypedArray<Transform3D> xforms = triple[0];
-				PackedColorArray colors = triple[1];
-				TypedArray<Transform3D> updated_xforms;
-				PackedColorArray updated_colors;
-				for (int i = 0; i < xforms.size(); i++) {
-					Transform3D t = xforms[i];
+				Array pair = cell_inst_dict[cell];
+				PackedFloat32Array buffer = pair[0];
+				// Adjust heights in place, compacting out instances over new holes
+				float *instances = buffer.ptrw();
+				int kept = 0;
+				for (int i = 0; i < buffer.size(); i += INSTANCE_STRIDE) {
+					Transform3D t = read_transform(instances + i);
 					Vector3 global_origin(t.origin + global_local_offset);
 					if (rect.has_point(Vector2(global_origin.x, global_origin.z))) {
 						Vector3 height_offset = t.basis.get_column(1) * mesh_height_offset;
@@ -847,14 +916,17 @@ void Terrain3DInstancer::update_transforms(const AABB &p_aabb) {
 						t.origin.y = height;
 						t.origin += height_offset;
 					}
-					updated_xforms.push_back(t);
-					updated_colors.push_back(colors[i]);
+					if (kept != i) {
+						memmove(instances + kept, instances + i, INSTANCE_STRIDE * sizeof(float));
+					}
+					write_transform(instances + kept, t);
+					kept += INSTANCE_STRIDE;
 				}
-				if (updated_xforms.size() > 0) {
-					triple[0] = updated_xforms;
-					triple[1] = updated_colors;
-					triple[2] = true;
-					cell_inst_dict[cell] = triple;
+				if (kept > 0) {
+					buffer.resize(kept);
+					pair[0] = buffer;
+					pair[1] = true;
+					cell_inst_dict[cell] = pair;
 				} else {
 					// Removed if a hole erased everything
 					cell_inst_dict.erase(cell);
@@ -903,27 +975,26 @@ void Terrain3DInstancer::copy_paste_dfr(const Terrain3DRegion *p_src_region, con
 	Dictionary mesh_inst_dict = p_src_region->get_instances();
 	Array mesh_types = mesh_inst_dict.keys();
 	for (int m = 0; m < mesh_types.size(); m++) {
-		TypedArray<Transform3D> xforms;
-		PackedColorArray colors;
-		Dictionary cell_inst_dict = p_src_region->get_instances()[m];
+		int mesh_id = mesh_types[m];
+		PackedFloat32Array buffer;
+		Dictionary cell_inst_dict = mesh_inst_dict[mesh_id];
 		Array cell_locs = cell_inst_dict.keys();
 		for (int c = 0; c < cell_locs.size(); c++) {
 			if (cells_to_copy.has(cell_locs[c])) {
-				Array triple = cell_inst_dict[cell_locs[c]];
-				TypedArray<Transform3D> cell_xforms = triple[0];
-				PackedColorArray cell_colors = triple[1];
-				for (int i = 0; i < cell_xforms.size(); i++) {
-					Transform3D t = cell_xforms[i];
-					t.origin += dst_translate;
-					xforms.push_back(t);
-					colors.push_back(cell_colors[i]);
-				}
+				Array pair = cell_inst_dict[cell_locs[c]];
+				buffer.append_array(pair[0]);
 			}
 		}
-		if (xforms.size() == 0) {
+		if (buffer.size() == 0) {
 			continue;
 		}
-		append_region(Ref<Terrain3DRegion>(p_dst_region), m, xforms, colors, false);
+		float *data = buffer.ptrw();
+		for (int i = 0; i < buffer.size(); i += INSTANCE_STRIDE) {
+			Transform3D t = read_transform(data + i);
+			t.origin += dst_translate;
+			write_transform(data + i, t);
+		}
+		_append_buffer(Ref<Terrain3DRegion>(p_dst_region), mesh_id, buffer, false);
 	}
 }
 
@@ -1002,15 +1073,14 @@ void Terrain3DInstancer::dump_data() {
 			Array cells = cell_inst_dict.keys();
 			for (int c = 0; c < cells.size(); c++) {
 				Vector2i cell = cells[c];
-				Array triple = cell_inst_dict[cell];
-				if (triple.size() != 3) {
-					LOG(WARN, "Malformed triple at cell ", cell, ": ", triple);
+				Array pair = cell_inst_dict[cell];
+				if (pair.size() != 2) {
+					LOG(WARN, "Malformed pair at cell ", cell, ": ", pair);
 					continue;
 				}
-				Array xforms = triple[0];
-				Array colors = triple[1];
-				bool modified = triple[2];
-				LOG(MESG, "Mesh: ", mesh_id, " cell: ", cell, " xforms: ", xforms.size(), " colors: ", colors.size(), " modified: ", modified);
+				PackedFloat32Array buffer = pair[0];
+				bool modified = pair[1];
+				LOG(MESG, "Mesh: ", mesh_id, " cell: ", cell, " instances: ", buffer.size() / INSTANCE_STRIDE, " modified: ", modified);
 			}
 		}
 	}
@@ -13,20 +13,25 @@ using namespace godot;
 
 class Terrain3D;
 class Terrain3DAssets;
+class Terrain3DData;
 
 class Terrain3DInstancer : public Object {
 	GDCLASS(Terrain3DInstancer, Object);
 	CLASS_NAME();
 	friend Terrain3D;
+	friend Terrain3DData;
 
 public: // Constants
 	static inline const int CELL_SIZE = 32;
+	static inline const int INSTANCE_STRIDE = 16; // Floats per instance in a cell buffer
 
 private:
 	Terrain3D *_terrain = nullptr;
 
 	// MM Resources stored in Terrain3DRegion::_instances as
-	// Region::_instances{mesh_id:int} -> cell{v2i} -> [ TypedArray<Transform3D>, PackedColorArray, modified:bool ]
+	// Region::_instances{mesh_id:int} -> cell{v2i} -> [ PackedFloat32Array, modified:bool ]
+	// Cell buffers have the layout of MultiMesh::set_buffer() with TRANSFORM_3D and colors, so MMs
+	// are filled with one copy. Per instance: 3 basis rows each followed by an origin axis, then color.
 
 	// MMI Objects attached to tree, freed in destructor, stored as
 	// _mmi_nodes{region_loc} -> mesh{v2i(mesh_id,lod)} -> cell{v2i} -> MultiMeshInstance3D
@@ -47,7 +52,10 @@ private:
 	void _destroy_mmi_by_location(const Vector2i &p_region_loc, const int p_mesh_id);
 	void _backup_regionl(const Vector2i &p_region_loc);
 	void _backup_region(const Ref<Terrain3DRegion> &p_region);
-	Ref<MultiMesh> _create_multimesh(const int p_mesh_id, const TypedArray<Transform3D> &p_xforms = TypedArray<Transform3D>(), const PackedColorArray &p_colors = PackedColorArray()) const;
+	Ref<MultiMesh> _create_multimesh(const int p_mesh_id, const PackedFloat32Array &p_buffer = PackedFloat32Array()) const;
+	void _fill_multimesh(const Ref<MultiMesh> &p_mm, const PackedFloat32Array &p_buffer) const;
+	void _add_buffer(const int p_mesh_id, const PackedFloat32Array &p_buffer, const bool p_update);
+	void _append_buffer(const Ref<Terrain3DRegion> &p_region, const int p_mesh_id, const PackedFloat32Array &p_buffer, const bool p_update);
 	Vector2i _get_cell(const Vector3 &p_global_position, const int p_region_size);
 
 public:
@@ -75,6 +83,12 @@ public:
 	void swap_ids(const int p_src_id, const int p_dst_id);
 	void force_update_mmis();
 
+	static PackedFloat32Array pack_instances(const TypedArray<Transform3D> &p_xforms, const PackedColorArray &p_colors);
+	static Transform3D read_transform(const float *p_instance);
+	static Color read_color(const float *p_instance);
+	static void write_transform(float *r_instance, const Transform3D &p_xform);
+	static void write_color(float *r_instance, const Color &p_color);
+
 	void reset_density_counter() { _density_counter = 0; }
 	void dump_data();
 	void dump_mmis();
@@ -95,4 +109,32 @@ inline uint32_t Terrain3DInstancer::_get_density_count(const real_t p_density) {
 	return count;
 }
 
+inline Transform3D Terrain3DInstancer::read_transform(const float *p_instance) {
+	return Transform3D(
+			p_instance[0], p_instance[1], p_instance[2],
+			p_instance[4], p_instance[5], p_instance[6],
+			p_instance[8], p_instance[9], p_instance[10],
+			p_instance[3], p_instance[7], p_instance[11]);
+}
+
+inline Color Terrain3DInstancer::read_color(const float *p_instance) {
+	return Color(p_instance[12], p_instance[13], p_instance[14], p_instance[15]);
+}
+
+inline void Terrain3DInstancer::write_transform(float *r_instance, const Transform3D &p_xform) {
+	for (int i = 0; i < 3; i++) {
+		r_instance[i * 4 + 0] = p_xform.basis.rows[i].x;
+		r_instance[i * 4 + 1] = p_xform.basis.rows[i].y;
+		r_instance[i * 4 + 2] = p_xform.basis.rows[i].z;
+		r_instance[i * 4 + 3] = p_xform.origin[i];
+	}
+}
+
+inline void Terrain3DInstancer::write_color(float *r_instance, const Color &p_color) {
+	r_instance[12] = p_color.r;
+	r_instance[13] = p_color.g;
+	r_instance[14] = p_color.b;
+	r_instance[15] = p_color.a;
+}
+
 #endif // TERRAIN3D_INSTANCER_CLASS_H
\ No newline at end of file
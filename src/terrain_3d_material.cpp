@@ -414,7 +414,8 @@ void Terrain3DMaterial::_update_maps() {
 		}
 	}
 
-	TypedArray<Vector2i> region_locations = data->get_region_locations();
+	// Indexed by region id, the texture array layer
+	TypedArray<Vector2i> region_locations = data->get_layer_locations();
 	LOG(EXTREME, "Region_locations size: ", region_locations.size(), " ", region_locations);
 	RS->material_set_param(_material, "_region_locations", region_locations);
 
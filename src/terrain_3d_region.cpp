@@ -1,18 +1,84 @@
 // Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
 
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/resource_saver.hpp>
 
 #include "logger.h"
 #include "terrain_3d_data.h"
+#include "terrain_3d_instancer.h"
 #include "terrain_3d_region.h"
 #include "terrain_3d_util.h"
 
+/////////////////////
+// Private Functions
+/////////////////////
+
+// Merges the min/max and holes of the pixels within p_rect under the given cell into r_cell.
+// Cells fully enclosed by the rect are read from the pyramid, partial ones descend a level.
+void Terrain3DRegion::_query_height_pyramid(const int p_level, const Vector2i &p_cell, const Rect2i &p_rect,
+		const float *p_heights, const uint32_t *p_controls, HeightCell &r_cell) const {
+	int cell_size = 1 << p_level;
+	Rect2i cell_rect = Rect2i(p_cell * cell_size, V2I(cell_size));
+	if (!p_rect.intersects(cell_rect)) {
+		return;
+	}
+	HeightCell cell;
+	if (p_level == 0) {
+		int index = p_cell.y * _region_size + p_cell.x;
+		cell.min = p_heights[index];
+		cell.max = p_heights[index];
+		cell.hole = p_controls != nullptr && is_hole(p_controls[index]);
+	} else if (p_rect.encloses(cell_rect)) {
+		cell = _height_pyramid[_pyramid_offsets[p_level] + p_cell.y * (_region_size >> p_level) + p_cell.x];
+	} else {
+		for (int i = 0; i < 4; i++) {
+			_query_height_pyramid(p_level - 1, p_cell * 2 + Vector2i(i & 1, i >> 1), p_rect, p_heights, p_controls, r_cell);
+		}
+		return;
+	}
+	r_cell.min = MIN(r_cell.min, cell.min);
+	r_cell.max = MAX(r_cell.max, cell.max);
+	r_cell.hole = r_cell.hole || cell.hole;
+}
+
+// Converts instancer cells saved before INSTANCE_BUFFER_VERSION as
+// [ Array of Transform3D, PackedColorArray, modified ] to the instancer's buffer layout
+void Terrain3DRegion::_upgrade_instances() {
+	int converted = 0;
+	Array mesh_ids = _instances.keys();
+	for (int m = 0; m < mesh_ids.size(); m++) {
+		Dictionary cell_inst_dict = _instances[mesh_ids[m]];
+		Array cells = cell_inst_dict.keys();
+		for (int c = 0; c < cells.size(); c++) {
+			Array cell = cell_inst_dict[cells[c]];
+			// Regions created in memory start at the first version, but hold current cells
+			if (cell.size() != 3 || cell[0].get_type() != Variant::ARRAY) {
+				continue;
+			}
+			Array pair;
+			pair.resize(2);
+			pair[0] = Terrain3DInstancer::pack_instances(cell[0], cell[1]);
+			pair[1] = true;
+			cell_inst_dict[cells[c]] = pair;
+			converted++;
+		}
+	}
+	if (converted > 0) {
+		LOG(INFO, "Converted ", converted, " instancer cells in region ", _location, " to buffers");
+	}
+}
+
 /////////////////////
 // Public Functions
 /////////////////////
 
 void Terrain3DRegion::set_version(const real_t p_version) {
 	LOG(INFO, vformat("%.3f", p_version));
+	// Loaded data is brought up to date as the version is raised
+	if (_version < INSTANCE_BUFFER_VERSION && p_version >= INSTANCE_BUFFER_VERSION) {
+		_upgrade_instances();
+	}
 	_version = p_version;
 	if (_version < Terrain3DData::CURRENT_VERSION) {
 		LOG(WARN, "Region ", get_path(), " version ", vformat("%.3f", _version),
@@ -89,6 +155,7 @@ void Terrain3DRegion::set_control_map(const Ref<Image> &p_map) {
 		set_region_size((p_map.is_valid()) ? p_map->get_width() : 0);
 	}
 	_control_map = sanitize_map(TYPE_CONTROL, p_map);
+	_pyramid_dirty = true;
 }
 
 void Terrain3DRegion::set_color_map(const Ref<Image> &p_map) {
@@ -108,9 +175,14 @@ void Terrain3DRegion::sanitize_maps() {
 		LOG(ERROR, "Set region_size first");
 		return;
 	}
+	Ref<Image> height_map = _height_map;
+	Ref<Image> control_map = _control_map;
 	_height_map = sanitize_map(TYPE_HEIGHT, _height_map);
 	_control_map = sanitize_map(TYPE_CONTROL, _control_map);
 	_color_map = sanitize_map(TYPE_COLOR, _color_map);
+	if (_height_map != height_map || _control_map != control_map) {
+		_pyramid_dirty = true;
+	}
 }
 
 Ref<Image> Terrain3DRegion::sanitize_map(const MapType p_map_type, const Ref<Image> &p_map) const {
@@ -184,8 +256,14 @@ void Terrain3DRegion::set_height_range(const Vector2 &p_range) {
 	}
 }
 
+// Rescans every pixel, rebuilding the height pyramid in case the maps were edited directly
 void Terrain3DRegion::calc_height_range() {
-	Vector2 range = Util::get_min_max(_height_map);
+	Vector2 range;
+	bool hole;
+	_pyramid_dirty = true;
+	if (!query_height_pyramid(Rect2i(V2I_ZERO, V2I(_region_size)), range, hole)) {
+		range = Util::get_min_max(_height_map);
+	}
 	if (_height_range != range) {
 		_height_range = range;
 		_modified = true;
@@ -193,6 +271,153 @@ void Terrain3DRegion::calc_height_range() {
 	}
 }
 
+/**
+ * Updates the min/max height pyramid from the height and control maps within p_rect, in pixels.
+ * An empty rect rebuilds it entirely. If a map was replaced, the pyramid is rebuilt on the next query
+ * instead. Call this after writing to the maps directly. Terrain3DData and the editor do so already.
+ */
+void Terrain3DRegion::update_height_pyramid(const Rect2i &p_rect) {
+	if (_pyramid_dirty && p_rect.has_area()) {
+		return;
+	}
+	if (_height_map.is_null() || !is_power_of_2(_region_size)) {
+		return;
+	}
+	int map_bytes = _region_size * _region_size * sizeof(float);
+	PackedByteArray height_data = _height_map->get_data();
+	if (height_data.size() < map_bytes) {
+		LOG(ERROR, "Height map doesn't match region size: ", _region_size);
+		return;
+	}
+	const float *heights = reinterpret_cast<const float *>(height_data.ptr());
+	PackedByteArray control_data;
+	const uint32_t *controls = nullptr;
+	if (_control_map.is_valid()) {
+		control_data = _control_map->get_data();
+		if (control_data.size() >= map_bytes) {
+			controls = reinterpret_cast<const uint32_t *>(control_data.ptr());
+		}
+	}
+
+	Rect2i rect = p_rect.intersection(Rect2i(V2I_ZERO, V2I(_region_size)));
+	if (!p_rect.has_area()) {
+		LOG(DEBUG, "Rebuilding height pyramid for region: ", (_location.x != INT32_MAX) ? String(_location) : "(new)");
+		rect = Rect2i(V2I_ZERO, V2I(_region_size));
+		_pyramid_offsets.clear();
+		_pyramid_offsets.push_back(0); // Level 0 is the height map
+		int count = 0;
+		for (int width = _region_size >> 1; width > 0; width >>= 1) {
+			_pyramid_offsets.push_back(count);
+			count += width * width;
+		}
+		_height_pyramid.resize(count);
+		int tiles = _region_size / HEIGHT_TILE_SIZE;
+		_height_tiles.resize(tiles * tiles);
+		_pyramid_dirty = false;
+	}
+	if (!rect.has_area()) {
+		return;
+	}
+
+	// Recalculate the cells covering the rect on each level from the 4 cells below
+	Vector2i start = rect.position;
+	Vector2i end = rect.get_end() - V2I(1);
+	for (int level = 1; level < int(_pyramid_offsets.size()); level++) {
+		start = Vector2i(start.x >> 1, start.y >> 1);
+		end = Vector2i(end.x >> 1, end.y >> 1);
+		int width = _region_size >> level;
+		HeightCell *cells = &_height_pyramid[_pyramid_offsets[level]];
+		const HeightCell *children = (level > 1) ? &_height_pyramid[_pyramid_offsets[level - 1]] : nullptr;
+		float *tiles = ((1 << level) == HEIGHT_TILE_SIZE) ? _height_tiles.ptrw() : nullptr;
+		for (int y = start.y; y <= end.y; y++) {
+			for (int x = start.x; x <= end.x; x++) {
+				HeightCell cell;
+				for (int i = 0; i < 4; i++) {
+					int cx = x * 2 + (i & 1);
+					int cy = y * 2 + (i >> 1);
+					if (level == 1) {
+						int index = cy * _region_size + cx;
+						cell.min = MIN(cell.min, heights[index]);
+						cell.max = MAX(cell.max, heights[index]);
+						cell.hole = cell.hole || (controls != nullptr && is_hole(controls[index]));
+					} else {
+						const HeightCell &child = children[cy * width * 2 + cx];
+						cell.min = MIN(cell.min, child.min);
+						cell.max = MAX(cell.max, child.max);
+						cell.hole = cell.hole || child.hole;
+					}
+				}
+				cells[y * width + x] = cell;
+				if (tiles != nullptr) {
+					tiles[y * width + x] = cell.max;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Finds the exact minimum and maximum heights, and whether there are any holes, within p_rect, in
+ * pixels. Walks the height pyramid, so it takes O(log n) for most rects. Returns false if the rect
+ * is outside of the region or the maps are invalid, leaving r_range and r_hole unchanged.
+ */
+bool Terrain3DRegion::query_height_pyramid(const Rect2i &p_rect, Vector2 &r_range, bool &r_hole) {
+	Rect2i rect = p_rect.intersection(Rect2i(V2I_ZERO, V2I(_region_size)));
+	if (!rect.has_area()) {
+		return false;
+	}
+	if (_pyramid_dirty) {
+		update_height_pyramid();
+		if (_pyramid_dirty) {
+			return false;
+		}
+	}
+	int map_bytes = _region_size * _region_size * sizeof(float);
+	PackedByteArray height_data = _height_map->get_data();
+	PackedByteArray control_data = _control_map.is_valid() ? _control_map->get_data() : PackedByteArray();
+	if (height_data.size() < map_bytes) {
+		return false;
+	}
+	const float *heights = reinterpret_cast<const float *>(height_data.ptr());
+	const uint32_t *controls = (control_data.size() >= map_bytes) ? reinterpret_cast<const uint32_t *>(control_data.ptr()) : nullptr;
+	HeightCell cell;
+	_query_height_pyramid(_pyramid_offsets.size() - 1, V2I_ZERO, rect, heights, controls, cell);
+	r_range = Vector2(cell.min, cell.max);
+	r_hole = cell.hole;
+	return true;
+}
+
+// Returns the min/max heights within the rect, in pixels, or NAN if outside of the region
+Vector2 Terrain3DRegion::get_height_range_rect(const Rect2i &p_rect) {
+	Vector2 range = Vector2(NAN, NAN);
+	bool hole = false;
+	query_height_pyramid(p_rect, range, hole);
+	return range;
+}
+
+// Returns true if any pixel within the rect, in pixels, is a hole
+bool Terrain3DRegion::has_hole_rect(const Rect2i &p_rect) {
+	Vector2 range;
+	bool hole = false;
+	query_height_pyramid(p_rect, range, hole);
+	return hole;
+}
+
+/**
+ * Returns the max height of each HEIGHT_TILE_SIZE square tile, row-major, rebuilding the height
+ * pyramid if needed. The tiles only bound the pixels within them. Returns an empty array if the
+ * maps are invalid.
+ */
+PackedFloat32Array Terrain3DRegion::get_height_tiles() {
+	if (_pyramid_dirty) {
+		update_height_pyramid();
+		if (_pyramid_dirty) {
+			return PackedFloat32Array();
+		}
+	}
+	return _height_tiles;
+}
+
 Error Terrain3DRegion::save(const String &p_path, const bool p_16_bit) {
 	// Initiate save to external file. The scene will save itself.
 	if (_location.x == INT32_MAX) {
@@ -214,26 +439,173 @@ Error Terrain3DRegion::save(const String &p_path, const bool p_16_bit) {
 	}
 	LOG(MESG, "Writing", (p_16_bit) ? " 16-bit" : "", " region ", _location, " to ", get_path());
 	set_version(Terrain3DData::CURRENT_VERSION);
-	Error err = OK;
-	if (p_16_bit) {
-		Ref<Image> original_map;
-		original_map.instantiate();
-		original_map->copy_from(_height_map);
-		_height_map->convert(Image::FORMAT_RH);
-		err = ResourceSaver::get_singleton()->save(this, get_path(), ResourceSaver::FLAG_COMPRESS);
-		_height_map = original_map;
-	} else {
-		err = ResourceSaver::get_singleton()->save(this, get_path(), ResourceSaver::FLAG_COMPRESS);
-	}
+	Error err = write_file(get_path(), p_16_bit);
 	if (err == OK) {
 		_modified = false;
 		LOG(INFO, "File saved successfully");
 	} else {
-		LOG(ERROR, "Cannot save region file: ", get_path(), ". Error code: ", ERROR, ". Look up @GlobalScope Error enum in the Godot docs");
+		LOG(ERROR, "Cannot save region file: ", get_path(), ". Error code: ", err, ". Look up @GlobalScope Error enum in the Godot docs");
+	}
+	return err;
+}
+
+/**
+ * Writes the region to p_path, leaving its path and modified state unchanged. The data goes to a
+ * temporary file beside p_path, which is renamed over it once complete, so an interrupted save
+ * leaves the previous file intact. Safe to call on a worker thread on a region nothing else is
+ * using, such as one from get_snapshot(). 16-bit heights are converted on a snapshot, here.
+ */
+Error Terrain3DRegion::write_file(const String &p_path, const bool p_16_bit) {
+	String temp_path = p_path.get_basename() + ".tmp." + p_path.get_extension();
+	Error err = OK;
+	if (p_path.get_extension() == RAW_EXTENSION) {
+		if (p_16_bit) {
+			LOG(DEBUG, "Raw region files always store 32-bit heights");
+		}
+		err = save_raw(temp_path);
+	} else {
+		Ref<Terrain3DRegion> region = this;
+		if (p_16_bit && _height_map.is_valid()) {
+			region = get_snapshot();
+			region->_height_map->convert(Image::FORMAT_RH);
+		}
+		err = ResourceSaver::get_singleton()->save(region, temp_path, ResourceSaver::FLAG_COMPRESS);
+	}
+	if (err == OK) {
+		err = DirAccess::rename_absolute(temp_path, p_path);
+	}
+	if (err != OK && FileAccess::file_exists(temp_path)) {
+		DirAccess::remove_absolute(temp_path);
+	}
+	return err;
+}
+
+/**
+ * Writes the region to p_path in the raw .t3dr format, leaving the region's path unchanged.
+ * The file has a RAW_HEADER_SIZE header, then the height, control, and color map data and the
+ * instances, each starting on a RAW_ALIGNMENT boundary. Maps are stored uncompressed in their
+ * Image formats, so load_raw() reads each straight into its Image. Header, little endian:
+ *  0: magic u32, 4: format version u32, 8: region size u32, 12: flags u32 (1 = color mipmaps)
+ *  16: version f32, 20: vertex spacing f32, 24: height range 2x f32
+ *  32: offset u64 and size u64 of each block: height, control, color, instances. Then zeros.
+ */
+Error Terrain3DRegion::save_raw(const String &p_path) const {
+	if (_height_map.is_null() || _control_map.is_null() || _color_map.is_null()) {
+		LOG(ERROR, "Region ", _location, " is missing maps. Skipping ", p_path);
+		return ERR_UNCONFIGURED;
+	}
+	PackedByteArray blocks[4] = {
+		_height_map->get_data(),
+		_control_map->get_data(),
+		_color_map->get_data(),
+		UtilityFunctions::var_to_bytes(_instances),
+	};
+
+	PackedByteArray header;
+	header.resize(RAW_HEADER_SIZE);
+	header.fill(0);
+	header.encode_u32(0, RAW_MAGIC);
+	header.encode_u32(4, RAW_FORMAT_VERSION);
+	header.encode_u32(8, _region_size);
+	header.encode_u32(12, _color_map->has_mipmaps() ? 1 : 0);
+	header.encode_float(16, _version);
+	header.encode_float(20, _vertex_spacing);
+	header.encode_float(24, _height_range.x);
+	header.encode_float(28, _height_range.y);
+	uint64_t offsets[4];
+	uint64_t end = RAW_HEADER_SIZE;
+	for (int i = 0; i < 4; i++) {
+		offsets[i] = (end + RAW_ALIGNMENT - 1) / RAW_ALIGNMENT * RAW_ALIGNMENT;
+		end = offsets[i] + blocks[i].size();
+		header.encode_u64(32 + i * 16, offsets[i]);
+		header.encode_u64(40 + i * 16, blocks[i].size());
+	}
+
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	if (file.is_null()) {
+		LOG(ERROR, "Cannot open file for writing: ", p_path, ", error: ", UtilityFunctions::error_string(FileAccess::get_open_error()));
+		return FileAccess::get_open_error();
+	}
+	file->store_buffer(header);
+	PackedByteArray padding;
+	for (int i = 0; i < 4; i++) {
+		padding.resize(offsets[i] - file->get_position());
+		padding.fill(0);
+		file->store_buffer(padding);
+		file->store_buffer(blocks[i]);
+	}
+	Error err = file->get_error();
+	if (err != OK) {
+		LOG(ERROR, "Cannot write raw region file: ", p_path, ", error: ", UtilityFunctions::error_string(err));
 	}
 	return err;
 }
 
+/**
+ * Reads a region written by save_raw() into this new region. Each map is read in one call into the
+ * buffer its Image uses, without decompressing or converting. The location is not stored in the
+ * file; set it from the file name.
+ */
+Error Terrain3DRegion::load_raw(const String &p_path) {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+	if (file.is_null()) {
+		LOG(ERROR, "Cannot open file: ", p_path, ", error: ", UtilityFunctions::error_string(FileAccess::get_open_error()));
+		return FileAccess::get_open_error();
+	}
+	PackedByteArray header = file->get_buffer(RAW_HEADER_SIZE);
+	if (header.size() < RAW_HEADER_SIZE || header.decode_u32(0) != RAW_MAGIC) {
+		LOG(ERROR, "Not a raw region file: ", p_path);
+		return ERR_FILE_CORRUPT;
+	}
+	if (header.decode_u32(4) > RAW_FORMAT_VERSION) {
+		LOG(ERROR, "Raw region file format ", header.decode_u32(4), " is newer than supported ", RAW_FORMAT_VERSION, ": ", p_path);
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	int region_size = header.decode_u32(8);
+	if (!is_power_of_2(region_size) || region_size < 64 || region_size > 2048) {
+		LOG(ERROR, "Invalid region size ", region_size, " in ", p_path);
+		return ERR_FILE_CORRUPT;
+	}
+	PackedByteArray blocks[4];
+	uint64_t length = file->get_length();
+	for (int i = 0; i < 4; i++) {
+		uint64_t offset = header.decode_u64(32 + i * 16);
+		uint64_t size = header.decode_u64(40 + i * 16);
+		if (offset < RAW_HEADER_SIZE || offset + size > length) {
+			LOG(ERROR, "Raw region file is truncated or corrupt: ", p_path);
+			return ERR_FILE_CORRUPT;
+		}
+		file->seek(offset);
+		blocks[i] = file->get_buffer(size);
+	}
+	int map_bytes = region_size * region_size * 4;
+	if (blocks[TYPE_HEIGHT].size() != map_bytes || blocks[TYPE_CONTROL].size() != map_bytes) {
+		LOG(ERROR, "Map sizes don't match region size ", region_size, " in ", p_path);
+		return ERR_FILE_CORRUPT;
+	}
+	bool color_mipmaps = (header.decode_u32(12) & 1) != 0;
+	Ref<Image> maps[TYPE_MAX];
+	for (int i = 0; i < TYPE_MAX; i++) {
+		maps[i] = Image::create_from_data(region_size, region_size, i == TYPE_COLOR && color_mipmaps, FORMAT[i], blocks[i]);
+		if (maps[i].is_null() || maps[i]->is_empty()) {
+			LOG(ERROR, "Cannot read ", TYPESTR[i], " from ", p_path);
+			return ERR_FILE_CORRUPT;
+		}
+	}
+
+	set_version(header.decode_float(16));
+	set_region_size(region_size);
+	set_vertex_spacing(header.decode_float(20));
+	_height_range = Vector2(header.decode_float(24), header.decode_float(28));
+	_height_map = maps[TYPE_HEIGHT];
+	_control_map = maps[TYPE_CONTROL];
+	_color_map = maps[TYPE_COLOR];
+	set_instances(UtilityFunctions::bytes_to_var(blocks[3]));
+	_pyramid_dirty = true;
+	_modified = false;
+	return OK;
+}
+
 void Terrain3DRegion::set_location(const Vector2i &p_location) {
 	// In the future anywhere they want to put the location might be fine, but because of region_map
 	// We have a limitation of 16x16 and eventually 45x45.
@@ -263,6 +635,7 @@ void Terrain3DRegion::set_data(const Dictionary &p_data) {
 	SET_IF_HAS(_control_map, "control_map");
 	SET_IF_HAS(_color_map, "color_map");
 	SET_IF_HAS(_instances, "instances");
+	_pyramid_dirty = true;
 }
 
 Dictionary Terrain3DRegion::get_data() const {
@@ -307,6 +680,33 @@ Ref<Terrain3DRegion> Terrain3DRegion::duplicate(const bool p_deep) {
 	return region;
 }
 
+/**
+ * Returns a copy of this region for saving or reading on another thread. The maps are new Images
+ * sharing this region's map buffers until either side writes to them, so this is cheap.
+ */
+Ref<Terrain3DRegion> Terrain3DRegion::get_snapshot() const {
+	Ref<Terrain3DRegion> region;
+	region.instantiate();
+	region->_version = _version;
+	region->_region_size = _region_size;
+	region->_vertex_spacing = _vertex_spacing;
+	region->_height_range = _height_range;
+	region->_location = _location;
+	region->_modified = _modified;
+	Ref<Image> maps[TYPE_MAX] = { _height_map, _control_map, _color_map };
+	for (int i = 0; i < TYPE_MAX; i++) {
+		if (maps[i].is_valid()) {
+			maps[i] = Image::create_from_data(maps[i]->get_width(), maps[i]->get_height(),
+					maps[i]->has_mipmaps(), maps[i]->get_format(), maps[i]->get_data());
+		}
+	}
+	region->_height_map = maps[TYPE_HEIGHT];
+	region->_control_map = maps[TYPE_CONTROL];
+	region->_color_map = maps[TYPE_COLOR];
+	region->_instances = _instances.duplicate(true);
+	return region;
+}
+
 /////////////////////
 // Protected Functions
 /////////////////////
@@ -343,11 +743,17 @@ void Terrain3DRegion::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("update_height", "height"), &Terrain3DRegion::update_height);
 	ClassDB::bind_method(D_METHOD("update_heights", "low_high"), &Terrain3DRegion::update_heights);
 	ClassDB::bind_method(D_METHOD("calc_height_range"), &Terrain3DRegion::calc_height_range);
+	ClassDB::bind_method(D_METHOD("update_height_pyramid", "rect"), &Terrain3DRegion::update_height_pyramid, DEFVAL(Rect2i()));
+	ClassDB::bind_method(D_METHOD("get_height_range_rect", "rect"), &Terrain3DRegion::get_height_range_rect);
+	ClassDB::bind_method(D_METHOD("has_hole_rect", "rect"), &Terrain3DRegion::has_hole_rect);
 
 	ClassDB::bind_method(D_METHOD("set_instances", "instances"), &Terrain3DRegion::set_instances);
 	ClassDB::bind_method(D_METHOD("get_instances"), &Terrain3DRegion::get_instances);
 
 	ClassDB::bind_method(D_METHOD("save", "path", "16-bit"), &Terrain3DRegion::save, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("write_file", "path", "16-bit"), &Terrain3DRegion::write_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("save_raw", "path"), &Terrain3DRegion::save_raw);
+	ClassDB::bind_method(D_METHOD("load_raw", "path"), &Terrain3DRegion::load_raw);
 
 	ClassDB::bind_method(D_METHOD("set_deleted", "deleted"), &Terrain3DRegion::set_deleted);
 	ClassDB::bind_method(D_METHOD("is_deleted"), &Terrain3DRegion::is_deleted);
@@ -361,6 +767,7 @@ void Terrain3DRegion::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_data", "data"), &Terrain3DRegion::set_data);
 	ClassDB::bind_method(D_METHOD("get_data"), &Terrain3DRegion::get_data);
 	ClassDB::bind_method(D_METHOD("duplicate", "deep"), &Terrain3DRegion::duplicate, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_snapshot"), &Terrain3DRegion::get_snapshot);
 
 	int ro_flags = PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_READ_ONLY;
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "version", PROPERTY_HINT_NONE, "", ro_flags), "set_version", "get_version");
@@ -3,6 +3,8 @@
 #ifndef TERRAIN3D_REGION_CLASS_H
 #define TERRAIN3D_REGION_CLASS_H
 
+#include <vector>
+
 #include "constants.h"
 #include "terrain_3d_util.h"
 
@@ -41,6 +43,19 @@ public: // Constants
 		COLOR_NAN, // TYPE_MAX, unused just in case someone indexes the array
 	};
 
+	// Data version from which instancer cells are stored as buffers. Earlier cells are converted by set_version().
+	static inline const real_t INSTANCE_BUFFER_VERSION = 0.94f;
+
+	// Size in pixels of the tiles in get_height_tiles(). Matches a level of the height pyramid.
+	static inline const int HEIGHT_TILE_SIZE = 16;
+
+	// Raw region file format, see save_raw()
+	static inline const char *RAW_EXTENSION = "t3dr";
+	static inline const uint32_t RAW_MAGIC = 0x52443354; // "T3DR" little endian
+	static inline const uint32_t RAW_FORMAT_VERSION = 1;
+	static inline const int RAW_HEADER_SIZE = 128;
+	static inline const int RAW_ALIGNMENT = 4096; // Of each data block in the file
+
 private:
 	// Saved data
 	real_t _version = 0.8f; // Set to first version to ensure we always upgrades this
@@ -51,7 +66,7 @@ private:
 	Ref<Image> _control_map;
 	Ref<Image> _color_map;
 	// Instancer
-	Dictionary _instances; // Meshes{int} -> Cells{v2i} -> [ Transform3D, Color, Modified ]
+	Dictionary _instances; // Meshes{int} -> Cells{v2i} -> [ MultiMesh buffer, Modified ]
 	real_t _vertex_spacing = 1.f; // Vertex Spacing value that transforms are currently scaled.
 
 	// Working data not saved to disk
@@ -60,6 +75,22 @@ private:
 	bool _modified = false; // Marked for saving
 	Vector2i _location = V2I_MAX;
 
+	// Min/max height pyramid, not saved. Level 0 is the height map itself. Level 1 cells cover
+	// 2x2 pixels, and each level above halves the resolution until one cell covers the region.
+	struct HeightCell {
+		float min = FLT_MAX;
+		float max = -FLT_MAX;
+		bool hole = false;
+	};
+	std::vector<HeightCell> _height_pyramid;
+	std::vector<int> _pyramid_offsets; // Index of the first cell of each level in _height_pyramid
+	bool _pyramid_dirty = true; // Rebuilt on the next query
+	PackedFloat32Array _height_tiles; // Max height of each HEIGHT_TILE_SIZE tile, shared with height samplers
+
+	void _query_height_pyramid(const int p_level, const Vector2i &p_cell, const Rect2i &p_rect,
+			const float *p_heights, const uint32_t *p_controls, HeightCell &r_cell) const;
+	void _upgrade_instances();
+
 public:
 	Terrain3DRegion() {}
 	~Terrain3DRegion() {}
@@ -72,6 +103,7 @@ public:
 	// Maps
 	void set_map(const MapType p_map_type, const Ref<Image> &p_image);
 	Ref<Image> get_map(const MapType p_map_type) const;
+	Image *get_map_ptr(const MapType p_map_type) const;
 	void set_maps(const TypedArray<Image> &p_maps);
 	TypedArray<Image> get_maps() const;
 	void set_height_map(const Ref<Image> &p_map);
@@ -89,6 +121,11 @@ public:
 	void update_height(const real_t p_height);
 	void update_heights(const Vector2 &p_low_high);
 	void calc_height_range();
+	void update_height_pyramid(const Rect2i &p_rect = Rect2i());
+	bool query_height_pyramid(const Rect2i &p_rect, Vector2 &r_range, bool &r_hole);
+	Vector2 get_height_range_rect(const Rect2i &p_rect);
+	bool has_hole_rect(const Rect2i &p_rect);
+	PackedFloat32Array get_height_tiles();
 
 	// Instancer
 	void set_instances(const Dictionary &p_instances) { _instances = p_instances; }
@@ -98,6 +135,9 @@ public:
 
 	// File I/O
 	Error save(const String &p_path = "", const bool p_16_bit = false);
+	Error write_file(const String &p_path, const bool p_16_bit = false);
+	Error save_raw(const String &p_path) const;
+	Error load_raw(const String &p_path);
 
 	// Working Data
 	void set_deleted(const bool p_deleted) { _deleted = p_deleted; }
@@ -113,6 +153,7 @@ public:
 	void set_data(const Dictionary &p_data);
 	Dictionary get_data() const;
 	Ref<Terrain3DRegion> duplicate(const bool p_deep = false);
+	Ref<Terrain3DRegion> get_snapshot() const;
 
 protected:
 	static void _bind_methods();
@@ -130,6 +171,20 @@ constexpr inline const Color *COLOR = Terrain3DRegion::COLOR;
 
 // Inline functions
 
+// Returns a raw pointer to the map for hot paths, avoiding Ref refcounting. Null if type is invalid.
+inline Image *Terrain3DRegion::get_map_ptr(const MapType p_map_type) const {
+	switch (p_map_type) {
+		case TYPE_HEIGHT:
+			return _height_map.ptr();
+		case TYPE_CONTROL:
+			return _control_map.ptr();
+		case TYPE_COLOR:
+			return _color_map.ptr();
+		default:
+			return nullptr;
+	}
+}
+
 inline void Terrain3DRegion::update_height(const real_t p_height) {
 	if (p_height < _height_range.x) {
 		_height_range.x = p_height;
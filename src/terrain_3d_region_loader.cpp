@@ -0,0 +1,32 @@
+// Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
+
+#include "terrain_3d_region.h"
+#include "terrain_3d_region_loader.h"
+
+///////////////////////////
+// Public Functions
+///////////////////////////
+
+PackedStringArray Terrain3DRegionLoader::_get_recognized_extensions() const {
+	PackedStringArray extensions;
+	extensions.push_back(Terrain3DRegion::RAW_EXTENSION);
+	return extensions;
+}
+
+bool Terrain3DRegionLoader::_handles_type(const StringName &p_type) const {
+	return p_type == StringName("Terrain3DRegion");
+}
+
+String Terrain3DRegionLoader::_get_resource_type(const String &p_path) const {
+	return (p_path.get_extension().to_lower() == Terrain3DRegion::RAW_EXTENSION) ? "Terrain3DRegion" : "";
+}
+
+Variant Terrain3DRegionLoader::_load(const String &p_path, const String &p_original_path, const bool p_use_sub_threads, const int32_t p_cache_mode) const {
+	Ref<Terrain3DRegion> region;
+	region.instantiate();
+	Error err = region->load_raw(p_path);
+	if (err != OK) {
+		return err;
+	}
+	return region;
+}
@@ -0,0 +1,28 @@
+// Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
+
+#ifndef TERRAIN3D_REGION_LOADER_CLASS_H
+#define TERRAIN3D_REGION_LOADER_CLASS_H
+
+#include <godot_cpp/classes/resource_format_loader.hpp>
+
+#include "constants.h"
+
+using namespace godot;
+
+// Lets ResourceLoader read raw .t3dr region files, written by Terrain3DRegion::save_raw(),
+// including threaded loads. Registered in register_types.cpp.
+class Terrain3DRegionLoader : public ResourceFormatLoader {
+	GDCLASS(Terrain3DRegionLoader, ResourceFormatLoader);
+	CLASS_NAME();
+
+public:
+	PackedStringArray _get_recognized_extensions() const override;
+	bool _handles_type(const StringName &p_type) const override;
+	String _get_resource_type(const String &p_path) const override;
+	Variant _load(const String &p_path, const String &p_original_path, const bool p_use_sub_threads, const int32_t p_cache_mode) const override;
+
+protected:
+	static void _bind_methods() {}
+};
+
+#endif // TERRAIN3D_REGION_LOADER_CLASS_H
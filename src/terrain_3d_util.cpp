@@ -1,11 +1,158 @@
 // Copyright © 2025 Cory Petkovsek, Roope Palmroos, and Contributors.
 
+#include <godot_cpp/classes/dir_access.hpp>
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/resource_saver.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "logger.h"
+#include "terrain_3d_region.h"
 #include "terrain_3d_util.h"
 
+///////////////////////////
+// Private Functions
+///////////////////////////
+
+// Returns how many chunks to split p_count pixels into. Only large images on the main thread are
+// split, as the regions loaded and imported on worker threads are already processed in parallel.
+int Terrain3DUtil::_get_chunk_count(const int64_t p_count) {
+	if (p_count < PARALLEL_PIXELS || OS::get_singleton()->get_thread_caller_id() != OS::get_singleton()->get_main_thread_id()) {
+		return 1;
+	}
+	int64_t chunks = MIN(int64_t(OS::get_singleton()->get_processor_count()) * 2, p_count / (PARALLEL_PIXELS / 4));
+	return MAX(1, int(chunks));
+}
+
+// Calls p_func(chunk, from, to) for each of p_chunks ranges of p_count pixels. A single chunk runs
+// on the calling thread. Returns once all have finished.
+void Terrain3DUtil::_parallel_for(const int64_t p_count, const int p_chunks, const std::function<void(const int, const int64_t, const int64_t)> &p_func) {
+	if (p_chunks <= 1) {
+		p_func(0, 0, p_count);
+		return;
+	}
+	ParallelJob job;
+	job.func = p_func;
+	job.count = p_count;
+	job.chunk_size = int_divide_ceil(p_count, int64_t(p_chunks));
+	// The job outlives the tasks, so its address is passed along as an int
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int64_t group_id = pool->add_group_task(callable_mp_static(&Terrain3DUtil::_parallel_chunk).bind(int64_t(&job)),
+			p_chunks, -1, true, "Terrain3DUtil image kernel");
+	pool->wait_for_group_task_completion(group_id);
+}
+
+void Terrain3DUtil::_parallel_chunk(const uint32_t p_index, const int64_t p_job) {
+	const ParallelJob *job = reinterpret_cast<const ParallelJob *>(p_job);
+	int64_t from = int64_t(p_index) * job->chunk_size;
+	int64_t to = MIN(job->count, from + job->chunk_size);
+	if (from < to) {
+		job->func(p_index, from, to);
+	}
+}
+
+// Formats _read_pixels() can read directly from the image data
+bool Terrain3DUtil::_is_readable_format(const Image::Format p_format) {
+	switch (p_format) {
+		case Image::FORMAT_L8:
+		case Image::FORMAT_R8:
+		case Image::FORMAT_RGB8:
+		case Image::FORMAT_RGBA8:
+		case Image::FORMAT_RF:
+		case Image::FORMAT_RH:
+		case Image::FORMAT_RGBAF:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Returns the image if _read_pixels() can read it, otherwise a decompressed RGBAF copy
+Ref<Image> Terrain3DUtil::_get_readable(const Ref<Image> &p_image) {
+	if (_is_readable_format(p_image->get_format())) {
+		return p_image;
+	}
+	LOG(DEBUG, "Converting a copy of format ", p_image->get_format(), " to RGBAF");
+	Ref<Image> img;
+	img.instantiate();
+	img->copy_from(p_image);
+	if (img->is_compressed()) {
+		img->decompress();
+	}
+	img->clear_mipmaps();
+	img->convert(Image::FORMAT_RGBAF);
+	return img;
+}
+
+// Converts p_count pixels of the first mipmap, starting at p_start, to RGBA floats the way
+// Image::get_pixel() does. Each format has its own loop so the compiler can vectorize it.
+void Terrain3DUtil::_read_pixels(const uint8_t *p_src, const Image::Format p_format, const int64_t p_start, const int p_count, float *r_rgba) {
+	const float inv_255 = 1.f / 255.f;
+	switch (p_format) {
+		case Image::FORMAT_L8: {
+			const uint8_t *src = p_src + p_start;
+			for (int i = 0; i < p_count; i++) {
+				float l = src[i] * inv_255;
+				r_rgba[i * 4 + 0] = l;
+				r_rgba[i * 4 + 1] = l;
+				r_rgba[i * 4 + 2] = l;
+				r_rgba[i * 4 + 3] = 1.f;
+			}
+		} break;
+		case Image::FORMAT_R8: {
+			const uint8_t *src = p_src + p_start;
+			for (int i = 0; i < p_count; i++) {
+				r_rgba[i * 4 + 0] = src[i] * inv_255;
+				r_rgba[i * 4 + 1] = 0.f;
+				r_rgba[i * 4 + 2] = 0.f;
+				r_rgba[i * 4 + 3] = 1.f;
+			}
+		} break;
+		case Image::FORMAT_RGB8: {
+			const uint8_t *src = p_src + p_start * 3;
+			for (int i = 0; i < p_count; i++) {
+				r_rgba[i * 4 + 0] = src[i * 3 + 0] * inv_255;
+				r_rgba[i * 4 + 1] = src[i * 3 + 1] * inv_255;
+				r_rgba[i * 4 + 2] = src[i * 3 + 2] * inv_255;
+				r_rgba[i * 4 + 3] = 1.f;
+			}
+		} break;
+		case Image::FORMAT_RGBA8: {
+			const uint8_t *src = p_src + p_start * 4;
+			for (int i = 0; i < p_count * 4; i++) {
+				r_rgba[i] = src[i] * inv_255;
+			}
+		} break;
+		case Image::FORMAT_RF: {
+			const float *src = reinterpret_cast<const float *>(p_src) + p_start;
+			for (int i = 0; i < p_count; i++) {
+				r_rgba[i * 4 + 0] = src[i];
+				r_rgba[i * 4 + 1] = 0.f;
+				r_rgba[i * 4 + 2] = 0.f;
+				r_rgba[i * 4 + 3] = 1.f;
+			}
+		} break;
+		case Image::FORMAT_RH: {
+			const uint16_t *src = reinterpret_cast<const uint16_t *>(p_src) + p_start;
+			for (int i = 0; i < p_count; i++) {
+				r_rgba[i * 4 + 0] = half_to_float(src[i]);
+				r_rgba[i * 4 + 1] = 0.f;
+				r_rgba[i * 4 + 2] = 0.f;
+				r_rgba[i * 4 + 3] = 1.f;
+			}
+		} break;
+		case Image::FORMAT_RGBAF: {
+			memcpy(r_rgba, reinterpret_cast<const float *>(p_src) + p_start * 4, p_count * 4 * sizeof(float));
+		} break;
+		default:
+			break;
+	}
+}
+
 ///////////////////////////
 // Public Functions
 ///////////////////////////
@@ -77,7 +224,7 @@ void Terrain3DUtil::dump_maps(const TypedArray<Image> &p_maps, const String &p_n
 
 // Expects a filename in a String like: "terrain3d-01_02.res" which returns (-1, 2)
 Vector2i Terrain3DUtil::filename_to_location(const String &p_filename) {
-	String location_string = p_filename.trim_prefix("terrain3d").trim_suffix(".res");
+	String location_string = p_filename.trim_prefix("terrain3d").trim_suffix(".res").trim_suffix(String(".") + Terrain3DRegion::RAW_EXTENSION);
 	return string_to_location(location_string);
 }
 
@@ -93,8 +240,8 @@ Vector2i Terrain3DUtil::string_to_location(const String &p_string) {
 }
 
 // Expects a v2i(-1,2) and returns terrain3d-01_02.res
-String Terrain3DUtil::location_to_filename(const Vector2i &p_region_loc) {
-	return "terrain3d" + location_to_string(p_region_loc) + ".res";
+String Terrain3DUtil::location_to_filename(const Vector2i &p_region_loc, const String &p_extension) {
+	return "terrain3d" + location_to_string(p_region_loc) + "." + p_extension;
 }
 
 // Expects a v2i(-1,2) and returns -01_02
@@ -107,17 +254,84 @@ String Terrain3DUtil::location_to_string(const Vector2i &p_region_loc) {
 	return x_str + y_str;
 }
 
+/**
+ * Converts all region files in p_dir from .res to the raw format written by
+ * Terrain3DRegion::save_raw(), or back if p_to_raw is false. Originals are removed once the new
+ * file is written. Reload the data directory afterwards.
+ */
+Error Terrain3DUtil::convert_region_files(const String &p_dir, const bool p_to_raw) {
+	Ref<DirAccess> da = DirAccess::open(p_dir);
+	if (da.is_null()) {
+		LOG(ERROR, "Cannot open directory: ", p_dir, " error: ", DirAccess::get_open_error());
+		return ERR_CANT_OPEN;
+	}
+	String from_ext = p_to_raw ? "res" : Terrain3DRegion::RAW_EXTENSION;
+	String to_ext = p_to_raw ? Terrain3DRegion::RAW_EXTENSION : "res";
+	PackedStringArray files = da->get_files();
+	int converted = 0;
+	Error result = OK;
+	for (int i = 0; i < files.size(); i++) {
+		String fname = files[i];
+		if (!fname.begins_with("terrain3d") || fname.get_extension() != from_ext) {
+			continue;
+		}
+		String path = p_dir + String("/") + fname;
+		String new_fname = fname.get_basename() + "." + to_ext;
+		Ref<Terrain3DRegion> region = ResourceLoader::get_singleton()->load(path, "Terrain3DRegion", ResourceLoader::CACHE_MODE_IGNORE);
+		if (region.is_null()) {
+			LOG(ERROR, "Cannot load region file: ", path);
+			result = ERR_FILE_CORRUPT;
+			continue;
+		}
+		Error err;
+		if (p_to_raw) {
+			err = region->save_raw(p_dir + String("/") + new_fname);
+		} else {
+			err = ResourceSaver::get_singleton()->save(region, p_dir + String("/") + new_fname, ResourceSaver::FLAG_COMPRESS);
+		}
+		if (err != OK) {
+			LOG(ERROR, "Cannot write ", new_fname, ", error: ", UtilityFunctions::error_string(err));
+			result = err;
+			continue;
+		}
+		err = da->remove(fname);
+		if (err != OK) {
+			LOG(ERROR, "Could not remove file: ", fname, ", error code: ", err);
+			result = err;
+		}
+		LOG(INFO, "Converted ", fname, " to ", new_fname);
+		converted++;
+	}
+	LOG(MESG, "Converted ", converted, " region files in ", p_dir, " to .", to_ext);
+	return result;
+}
+
 Ref<Image> Terrain3DUtil::black_to_alpha(const Ref<Image> &p_image) {
-	if (p_image.is_null()) {
+	if (p_image.is_null() || p_image->is_empty()) {
 		return Ref<Image>();
 	}
-	Ref<Image> img = Image::create_empty(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), Image::FORMAT_RGBAF);
-	for (int y = 0; y < img->get_height(); y++) {
-		for (int x = 0; x < img->get_width(); x++) {
-			Color pixel = p_image->get_pixel(x, y);
-			pixel.a = pixel.get_luminance();
-			img->set_pixel(x, y, pixel);
+	Ref<Image> src = _get_readable(p_image);
+	Image::Format format = src->get_format();
+	PackedByteArray src_data = src->get_data();
+	int64_t pixels = int64_t(src->get_width()) * src->get_height();
+	PackedByteArray dst_data;
+	dst_data.resize(pixels * 4 * sizeof(float));
+	const uint8_t *src_ptr = src_data.ptr();
+	float *dst = reinterpret_cast<float *>(dst_data.ptrw());
+	_parallel_for(pixels, _get_chunk_count(pixels), [&](const int p_chunk, const int64_t p_from, const int64_t p_to) {
+		for (int64_t i = p_from; i < p_to; i += PIXEL_BLOCK) {
+			int count = MIN(int64_t(PIXEL_BLOCK), p_to - i);
+			float *rgba = dst + i * 4;
+			_read_pixels(src_ptr, format, i, count, rgba);
+			for (int j = 0; j < count; j++) {
+				// Color::get_luminance()
+				rgba[j * 4 + 3] = 0.2126f * rgba[j * 4 + 0] + 0.7152f * rgba[j * 4 + 1] + 0.0722f * rgba[j * 4 + 2];
+			}
 		}
+	});
+	Ref<Image> img = Image::create_from_data(src->get_width(), src->get_height(), false, Image::FORMAT_RGBAF, dst_data);
+	if (p_image->has_mipmaps()) {
+		img->generate_mipmaps();
 	}
 	return img;
 }
@@ -134,20 +348,42 @@ Vector2 Terrain3DUtil::get_min_max(const Ref<Image> &p_image) {
 		return Vector2(INFINITY, INFINITY);
 	}
 
-	Vector2 min_max = Vector2(FLT_MAX, FLT_MIN);
-
-	for (int y = 0; y < p_image->get_height(); y++) {
-		for (int x = 0; x < p_image->get_width(); x++) {
-			Color col = p_image->get_pixel(x, y);
-			if (col.r < min_max.x) {
-				min_max.x = col.r;
+	Ref<Image> img = _get_readable(p_image);
+	Image::Format format = img->get_format();
+	PackedByteArray data = img->get_data();
+	const uint8_t *src = data.ptr();
+	int64_t pixels = int64_t(img->get_width()) * img->get_height();
+	int chunks = _get_chunk_count(pixels);
+	std::vector<Vector2> ranges(chunks, Vector2(FLT_MAX, -FLT_MAX));
+	_parallel_for(pixels, chunks, [&](const int p_chunk, const int64_t p_from, const int64_t p_to) {
+		float low = FLT_MAX;
+		float high = -FLT_MAX;
+		// NaN fails both comparisons, so is skipped
+		if (format == Image::FORMAT_RF) {
+			const float *values = reinterpret_cast<const float *>(src);
+			for (int64_t i = p_from; i < p_to; i++) {
+				low = std::min(low, values[i]);
+				high = std::max(high, values[i]);
 			}
-			if (col.r > min_max.y) {
-				min_max.y = col.r;
+		} else {
+			float rgba[PIXEL_BLOCK * 4];
+			for (int64_t i = p_from; i < p_to; i += PIXEL_BLOCK) {
+				int count = MIN(int64_t(PIXEL_BLOCK), p_to - i);
+				_read_pixels(src, format, i, count, rgba);
+				for (int j = 0; j < count; j++) {
+					low = std::min(low, rgba[j * 4]);
+					high = std::max(high, rgba[j * 4]);
+				}
 			}
 		}
-	}
+		ranges[p_chunk] = Vector2(low, high);
+	});
 
+	Vector2 min_max = Vector2(FLT_MAX, -FLT_MAX);
+	for (const Vector2 &range : ranges) {
+		min_max.x = MIN(min_max.x, range.x);
+		min_max.y = MAX(min_max.y, range.y);
+	}
 	LOG(INFO, "Calculating minimum and maximum values of the image: ", min_max);
 	return min_max;
 }
@@ -172,6 +408,7 @@ Ref<Image> Terrain3DUtil::get_thumbnail(const Ref<Image> &p_image, const Vector2
 	img.instantiate();
 	img->copy_from(p_image);
 	img->resize(size.x, size.y, Image::INTERPOLATE_LANCZOS);
+	img = _get_readable(img);
 
 	// Get minimum and maximum height values on the scaled image
 	Vector2 minmax = get_min_max(img);
@@ -184,17 +421,30 @@ Ref<Image> Terrain3DUtil::get_thumbnail(const Ref<Image> &p_image, const Vector2
 	hmax = (hmax == 0) ? 0.001f : hmax;
 
 	// Create a new image w / normalized values
-	Ref<Image> thumb = Image::create_empty(size.x, size.y, false, Image::FORMAT_RGB8);
-	for (int y = 0; y < thumb->get_height(); y++) {
-		for (int x = 0; x < thumb->get_width(); x++) {
-			Color col = img->get_pixel(x, y);
-			col.r = (col.r + hmin) / hmax;
-			col.g = col.r;
-			col.b = col.r;
-			thumb->set_pixel(x, y, col);
+	Image::Format format = img->get_format();
+	PackedByteArray src_data = img->get_data();
+	const uint8_t *src = src_data.ptr();
+	int64_t pixels = int64_t(size.x) * size.y;
+	PackedByteArray dst_data;
+	dst_data.resize(pixels * 3);
+	uint8_t *dst = dst_data.ptrw();
+	float offset = hmin;
+	float scale = 255.f / hmax;
+	_parallel_for(pixels, _get_chunk_count(pixels), [&](const int p_chunk, const int64_t p_from, const int64_t p_to) {
+		float rgba[PIXEL_BLOCK * 4];
+		for (int64_t i = p_from; i < p_to; i += PIXEL_BLOCK) {
+			int count = MIN(int64_t(PIXEL_BLOCK), p_to - i);
+			_read_pixels(src, format, i, count, rgba);
+			uint8_t *rgb = dst + i * 3;
+			for (int j = 0; j < count; j++) {
+				uint8_t value = uint8_t(std::min(255.f, std::max(0.f, (rgba[j * 4] + offset) * scale)));
+				rgb[j * 3 + 0] = value;
+				rgb[j * 3 + 1] = value;
+				rgb[j * 3 + 2] = value;
+			}
 		}
-	}
-	return thumb;
+	});
+	return Image::create_from_data(size.x, size.y, false, Image::FORMAT_RGB8, dst_data);
 }
 
 /* Get an Image filled with specified color and format
@@ -364,22 +614,41 @@ Ref<Image> Terrain3DUtil::pack_image(const Ref<Image> &p_src_rgb, const Ref<Imag
 		LOG(ERROR, "Source Channel of Height/Roughness invalid. Cannot Pack")
 		return Ref<Image>();
 	}
-	Ref<Image> dst = Image::create_empty(p_src_rgb->get_width(), p_src_rgb->get_height(), false, Image::FORMAT_RGBA8);
+	Ref<Image> rgb_img = _get_readable(p_src_rgb);
+	Ref<Image> a_img = _get_readable(p_src_a);
+	Image::Format rgb_format = rgb_img->get_format();
+	Image::Format a_format = a_img->get_format();
+	PackedByteArray rgb_data = rgb_img->get_data();
+	PackedByteArray a_data = a_img->get_data();
+	const uint8_t *rgb_src = rgb_data.ptr();
+	const uint8_t *a_src = a_data.ptr();
+	int64_t pixels = int64_t(rgb_img->get_width()) * rgb_img->get_height();
+	PackedByteArray dst_data;
+	dst_data.resize(pixels * 4);
+	uint8_t *dst = dst_data.ptrw();
+	float green_sign = p_invert_green ? -1.f : 1.f;
+	float green_offset = p_invert_green ? 1.f : 0.f;
+	float alpha_sign = p_invert_alpha ? -1.f : 1.f;
+	float alpha_offset = p_invert_alpha ? 1.f : 0.f;
 	LOG(INFO, "Creating image from source RGB + source channel images");
-	for (int y = 0; y < p_src_rgb->get_height(); y++) {
-		for (int x = 0; x < p_src_rgb->get_width(); x++) {
-			Color col = p_src_rgb->get_pixel(x, y);
-			col.a = p_src_a->get_pixel(x, y)[p_alpha_channel];
-			if (p_invert_green) {
-				col.g = 1.0f - col.g;
+	_parallel_for(pixels, _get_chunk_count(pixels), [&](const int p_chunk, const int64_t p_from, const int64_t p_to) {
+		float rgba[PIXEL_BLOCK * 4];
+		float alpha[PIXEL_BLOCK * 4];
+		for (int64_t i = p_from; i < p_to; i += PIXEL_BLOCK) {
+			int count = MIN(int64_t(PIXEL_BLOCK), p_to - i);
+			_read_pixels(rgb_src, rgb_format, i, count, rgba);
+			_read_pixels(a_src, a_format, i, count, alpha);
+			for (int j = 0; j < count; j++) {
+				rgba[j * 4 + 1] = green_offset + green_sign * rgba[j * 4 + 1];
+				rgba[j * 4 + 3] = alpha_offset + alpha_sign * alpha[j * 4 + p_alpha_channel];
 			}
-			if (p_invert_alpha) {
-				col.a = 1.0f - col.a;
+			uint8_t *out = dst + i * 4;
+			for (int j = 0; j < count * 4; j++) {
+				out[j] = uint8_t(std::min(255.f, std::max(0.f, rgba[j] * 255.f)));
 			}
-			dst->set_pixel(x, y, col);
 		}
-	}
-	return dst;
+	});
+	return Image::create_from_data(rgb_img->get_width(), rgb_img->get_height(), false, Image::FORMAT_RGBA8, dst_data);
 }
 
 // From source RGB, create a new L image that is scaled to use full 0 - 1 range.
@@ -392,34 +661,60 @@ Ref<Image> Terrain3DUtil::luminance_to_height(const Ref<Image> &p_src_rgb) {
 		LOG(ERROR, "Provided images are empty. Cannot pack");
 		return Ref<Image>();
 	}
-	real_t lum_contrast;
-	real_t l_max = 0.0f;
-	real_t l_min = 1.0f;
+	Ref<Image> img = _get_readable(p_src_rgb);
+	Image::Format format = img->get_format();
+	PackedByteArray src_data = img->get_data();
+	const uint8_t *src = src_data.ptr();
+	int64_t pixels = int64_t(img->get_width()) * img->get_height();
+	int chunks = _get_chunk_count(pixels);
+
 	// Calculate contrast and offset so that we can make the most use of the height channel range.
-	for (int y = 0; y < p_src_rgb->get_height(); y++) {
-		for (int x = 0; x < p_src_rgb->get_width(); x++) {
-			Color col = p_src_rgb->get_pixel(x, y);
-			real_t l = 0.299f * col.r + 0.587f * col.g + 0.114f * col.b;
-			l_max = MAX(l, l_max);
-			l_min = MIN(l, l_min);
+	std::vector<Vector2> ranges(chunks, Vector2(1.f, 0.f));
+	_parallel_for(pixels, chunks, [&](const int p_chunk, const int64_t p_from, const int64_t p_to) {
+		float rgba[PIXEL_BLOCK * 4];
+		float l_min = 1.f;
+		float l_max = 0.f;
+		for (int64_t i = p_from; i < p_to; i += PIXEL_BLOCK) {
+			int count = MIN(int64_t(PIXEL_BLOCK), p_to - i);
+			_read_pixels(src, format, i, count, rgba);
+			for (int j = 0; j < count; j++) {
+				float l = 0.299f * rgba[j * 4 + 0] + 0.587f * rgba[j * 4 + 1] + 0.114f * rgba[j * 4 + 2];
+				l_min = std::min(l_min, l);
+				l_max = std::max(l_max, l);
+			}
 		}
+		ranges[p_chunk] = Vector2(l_min, l_max);
+	});
+	real_t l_min = 1.0f;
+	real_t l_max = 0.0f;
+	for (const Vector2 &range : ranges) {
+		l_min = MIN(l_min, range.x);
+		l_max = MAX(l_max, range.y);
 	}
-	lum_contrast = 1.0f / MAX(l_max - l_min, 1e-6);
-	Ref<Image> dst = Image::create_empty(p_src_rgb->get_width(), p_src_rgb->get_height(), false, Image::FORMAT_RGB8);
-	for (int y = 0; y < p_src_rgb->get_height(); y++) {
-		for (int x = 0; x < p_src_rgb->get_width(); x++) {
-			Color col = p_src_rgb->get_pixel(x, y);
-			real_t lum = 0.299f * col.r + 0.587f * col.g + 0.114f * col.b;
-			lum = CLAMP((lum * lum_contrast - l_min), 0.0f, 1.0f);
-			// some shaping
-			col.r = 0.5f - sin(asin(1.0f - 2.0f * lum) / 3.0f);
-			col.g = col.r;
-			col.b = col.r;
-			col.a = col.r;
-			dst->set_pixel(x, y, col);
+	float lum_contrast = 1.0f / MAX(l_max - l_min, 1e-6);
+
+	PackedByteArray dst_data;
+	dst_data.resize(pixels * 3);
+	uint8_t *dst = dst_data.ptrw();
+	_parallel_for(pixels, chunks, [&](const int p_chunk, const int64_t p_from, const int64_t p_to) {
+		float rgba[PIXEL_BLOCK * 4];
+		for (int64_t i = p_from; i < p_to; i += PIXEL_BLOCK) {
+			int count = MIN(int64_t(PIXEL_BLOCK), p_to - i);
+			_read_pixels(src, format, i, count, rgba);
+			uint8_t *rgb = dst + i * 3;
+			for (int j = 0; j < count; j++) {
+				float lum = 0.299f * rgba[j * 4 + 0] + 0.587f * rgba[j * 4 + 1] + 0.114f * rgba[j * 4 + 2];
+				lum = CLAMP((lum * lum_contrast - float(l_min)), 0.0f, 1.0f);
+				// some shaping
+				float height = 0.5f - sin(asin(1.0f - 2.0f * lum) / 3.0f);
+				uint8_t value = uint8_t(CLAMP(height * 255.f, 0.f, 255.f));
+				rgb[j * 3 + 0] = value;
+				rgb[j * 3 + 1] = value;
+				rgb[j * 3 + 2] = value;
+			}
 		}
-	}
-	return dst;
+	});
+	return Image::create_from_data(img->get_width(), img->get_height(), false, Image::FORMAT_RGB8, dst_data);
 }
 
 ///////////////////////////
@@ -449,7 +744,10 @@ void Terrain3DUtil::_bind_methods() {
 
 	// String functions
 	ClassDB::bind_static_method("Terrain3DUtil", D_METHOD("filename_to_location", "filename"), &Terrain3DUtil::filename_to_location);
-	ClassDB::bind_static_method("Terrain3DUtil", D_METHOD("location_to_filename", "region_location"), &Terrain3DUtil::location_to_filename);
+	ClassDB::bind_static_method("Terrain3DUtil", D_METHOD("location_to_filename", "region_location", "extension"), &Terrain3DUtil::location_to_filename, DEFVAL("res"));
+
+	// File operations
+	ClassDB::bind_static_method("Terrain3DUtil", D_METHOD("convert_region_files", "directory", "to_raw"), &Terrain3DUtil::convert_region_files, DEFVAL(true));
 
 	// Image handling
 	ClassDB::bind_static_method("Terrain3DUtil", D_METHOD("black_to_alpha", "image"), &Terrain3DUtil::black_to_alpha);
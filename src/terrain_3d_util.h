@@ -6,6 +6,7 @@
 #include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/classes/resource_loader.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <functional>
 
 #include "constants.h"
 #include "generated_texture.h"
@@ -21,6 +22,25 @@ class Terrain3DUtil : public Object {
 	GDCLASS(Terrain3DUtil, Object);
 	CLASS_NAME_STATIC("Terrain3DUtil");
 
+private:
+	// Image kernels split images with more pixels than this across the WorkerThreadPool
+	static inline const int64_t PARALLEL_PIXELS = 512 * 512;
+	static inline const int PIXEL_BLOCK = 256; // Pixels converted at once into a stack buffer
+
+	// A range of pixels split into chunks, run by _parallel_chunk() on each worker
+	struct ParallelJob {
+		std::function<void(const int, const int64_t, const int64_t)> func;
+		int64_t count = 0;
+		int64_t chunk_size = 0;
+	};
+
+	static int _get_chunk_count(const int64_t p_count);
+	static void _parallel_for(const int64_t p_count, const int p_chunks, const std::function<void(const int, const int64_t, const int64_t)> &p_func);
+	static void _parallel_chunk(const uint32_t p_index, const int64_t p_job);
+	static bool _is_readable_format(const Image::Format p_format);
+	static Ref<Image> _get_readable(const Ref<Image> &p_image);
+	static void _read_pixels(const uint8_t *p_src, const Image::Format p_format, const int64_t p_start, const int p_count, float *r_rgba);
+
 public:
 	// Print info to the console
 	static void print_arr(const String &p_name, const Array &p_arr, const int p_level = 2); // Level 2: DEBUG
@@ -31,9 +51,12 @@ public:
 	// String functions
 	static Vector2i filename_to_location(const String &p_filename);
 	static Vector2i string_to_location(const String &p_string);
-	static String location_to_filename(const Vector2i &p_region_loc);
+	static String location_to_filename(const Vector2i &p_region_loc, const String &p_extension = "res");
 	static String location_to_string(const Vector2i &p_region_loc);
 
+	// File operations
+	static Error convert_region_files(const String &p_dir, const bool p_to_raw = true);
+
 	// Image operations
 	static Ref<Image> black_to_alpha(const Ref<Image> &p_image);
 	static Vector2 get_min_max(const Ref<Image> &p_image);
@@ -83,6 +106,26 @@ inline Vector3 v2v3(const Vector2 &p_v2) {
 	return Vector3(p_v2.x, 0., p_v2.y);
 }
 
+// Convert IEEE 754 half precision bits to float
+inline float half_to_float(const uint16_t p_half) {
+	uint32_t sign = uint32_t(p_half & 0x8000) << 16;
+	uint32_t exponent = (p_half >> 10) & 0x1F;
+	uint32_t mantissa = p_half & 0x3FF;
+	uint32_t bits;
+	if (exponent == 0) {
+		// Zero or subnormal, mantissa * 2^-24
+		float value = float(mantissa) / 16777216.f;
+		return sign ? -value : value;
+	} else if (exponent == 0x1F) {
+		bits = sign | 0x7F800000 | (mantissa << 13); // Inf or NaN
+	} else {
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
 ///////////////////////////
 // Math
 ///////////////////////////